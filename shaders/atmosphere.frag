@@ -1,12 +1,135 @@
 #version 330 core
-precision mediump float;
+precision highp float;
 
-out vec4 color;
+in vec2 v_texCoords;
 
-in vec3 v_color;
-in float v_alpha;
+// Dual source blending (GL_ONE, GL_SRC1_COLOR): scene = scene * transmittance + color
+layout(location = 0, index = 0) out vec4 color;
+layout(location = 0, index = 1) out vec4 transmittance;
+
+layout(std140) uniform PerView {
+    mat4 viewProjection;
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];
+    vec4 cascadeSplits;
+    vec3 camPos;
+};
+
+uniform sampler2D sceneDepth;
+uniform sampler2D transmittanceLUT;
+uniform sampler3D scatteringLUT;
+
+uniform mat4 inverseViewProjection;
+uniform vec3 planetCenter, sunDirection, rayleighScattering;
+uniform float planetRadius, atmosphereRadius, mieG, sunIntensity;
+
+// Sizes of the tables in AtmosphereLUT
+const vec2 TRANSMITTANCE_SIZE = vec2(256, 64);
+const vec3 SCATTERING_SIZE = vec3(32, 128, 32);
+
+const float PI = 3.14159265;
+
+// The mappings of AtmosphereLUT: squared zenith cosines and square root altitudes
+float unitFromMu(float mu)
+{
+    return .5 + .5 * sign(mu) * sqrt(abs(mu));
+}
+
+float unitFromR(float r)
+{
+    return sqrt(clamp((r - planetRadius) / (atmosphereRadius - planetRadius), 0., 1.));
+}
+
+// Texel i of n is at i / (n - 1)
+vec2 lutCoord(vec2 u, vec2 size) { return (u * (size - 1.) + .5) / size; }
+vec3 lutCoord(vec3 u, vec3 size) { return (u * (size - 1.) + .5) / size; }
+
+// Transmittance from radius r along zenith cosine mu to the ground or the top of the atmosphere
+vec3 transmittanceToEnd(float r, float mu)
+{
+    return texture(transmittanceLUT, lutCoord(vec2(unitFromMu(mu), unitFromR(r)), TRANSMITTANCE_SIZE)).rgb;
+}
+
+// Single scattering along the same ray, Rayleigh in rgb and the red channel of Mie in alpha
+vec4 scatteringToEnd(float r, float mu, float muS)
+{
+    return texture(scatteringLUT, lutCoord(vec3(muS * .5 + .5, unitFromMu(mu), unitFromR(r)), SCATTERING_SIZE));
+}
+
+// Transmittance between radius r and the point d further along mu.
+// Rays that go down are turned around, so both lookups are rays that miss the ground.
+vec3 transmittanceBetween(float r, float mu, float d)
+{
+    float r1 = sqrt(r * r + d * d + 2. * r * mu * d);
+    float mu1 = (r * mu + d) / r1;
+
+    if (mu > 0.) return min(transmittanceToEnd(r, mu) / transmittanceToEnd(r1, mu1), vec3(1.));
+    return min(transmittanceToEnd(r1, -mu1) / transmittanceToEnd(r, -mu), vec3(1.));
+}
 
 void main()
 {
-    color = vec4(v_color, v_alpha);
+    color = vec4(0.);
+    transmittance = vec4(1.);
+
+    vec2 ndc = v_texCoords * 2. - 1.;
+    vec4 farPoint = inverseViewProjection * vec4(ndc, 1., 1.);
+    vec3 v = normalize(farPoint.xyz / farPoint.w - camPos);
+
+    // Where the view ray enters and leaves the atmosphere
+    vec3 origin = camPos - planetCenter;
+    float rMu = dot(origin, v);
+    float discriminant = rMu * rMu - dot(origin, origin) + atmosphereRadius * atmosphereRadius;
+    if (discriminant < 0.) return;
+
+    float exit = -rMu + sqrt(discriminant);
+    if (exit < 0.) return;
+    float enter = max(0., -rMu - sqrt(discriminant));
+
+    float depth = texture(sceneDepth, v_texCoords).r;
+    float sceneDistance = 1e30;
+    if (depth < 1.)
+    {
+        vec4 scenePoint = inverseViewProjection * vec4(ndc, depth * 2. - 1., 1.);
+        sceneDistance = length(scenePoint.xyz / scenePoint.w - camPos);
+    }
+    if (sceneDistance <= enter) return;
+
+    vec3 x = origin + v * enter;
+    float r = length(x);
+    float mu = dot(x, v) / r;
+    float muS = dot(x, sunDirection) / r;
+    float nu = dot(v, sunDirection);
+
+    vec4 inscatter = scatteringToEnd(r, mu, muS);
+
+    // The tables end at the ground or the top of the atmosphere
+    float groundDiscriminant = r * r * (mu * mu - 1.) + planetRadius * planetRadius;
+    bool hitsGround = mu < 0. && groundDiscriminant >= 0.;
+    float rayEnd = hitsGround ? -r * mu - sqrt(groundDiscriminant) : exit - enter;
+
+    float d = sceneDistance - enter;
+    if (d < rayEnd)
+    {
+        // Something in the atmosphere: only the light scattered in front of it
+        vec3 x0 = x + v * d;
+        float r0 = length(x0);
+
+        vec3 segmentTransmittance = transmittanceBetween(r, mu, d);
+        inscatter -= vec4(segmentTransmittance, segmentTransmittance.r) * scatteringToEnd(r0, dot(x0, v) / r0, dot(x0, sunDirection) / r0);
+        transmittance.rgb = segmentTransmittance;
+    }
+    else transmittance.rgb = hitsGround ? vec3(0.) : transmittanceToEnd(r, mu);
+
+    inscatter = max(inscatter, vec4(0.));
+
+    // Mie from its red channel (Bruneton & Neyret), Mie scattering hardly depends on the wavelength
+    vec3 mie = inscatter.rgb * inscatter.a / max(inscatter.r, 1e-4) * rayleighScattering.r / rayleighScattering;
+
+    float phaseRayleigh = 3. / (16. * PI) * (1. + nu * nu);
+    float g2 = mieG * mieG;
+    float phaseMie = 3. / (8. * PI) * (1. - g2) * (1. + nu * nu) / ((2. + g2) * pow(1. + g2 - 2. * mieG * nu, 1.5));
+
+    color.rgb = (inscatter.rgb * phaseRayleigh + mie * phaseMie) * sunIntensity;
 }
@@ -4,31 +4,75 @@ precision mediump float;
 
 layout(location = 0) in vec3 a_pos;
 
-// per instance attributes:
-layout(location = 1) in vec3 spawnPoint;
+// per cloud attributes, they advance once every PARTICLES_PER_CLOUD instances:
+layout(location = 1) in vec4 cloudPath; // lon, lat (degrees) at spawn time, wind (degrees per second)
+layout(location = 2) in vec3 cloudLife; // spawn time, despawn time, nr of particles
 
 out vec2 v_texCoords, v_pos;
 out vec3 cloudColor;
 out float opacity;
 
-uniform mat4 mvp;
-uniform vec3 up, right;
-uniform float time, cloudOpacity, light;
+#define NR_OF_SPAWNPOINTS 30
+#define PARTICLES_PER_SPAWNPOINT 6
+#define PARTICLES_PER_CLOUD 180
+
+uniform mat4 mvp; // of the planet
+uniform vec3 up, right; // of the camera, in planet space
+uniform vec3 spawnPoints[NR_OF_SPAWNPOINTS];
+uniform float cloudDistance; // planet radius + cloud height
+
+layout(std140) uniform PerFrame {
+    vec3 sunDir;
+    float time;
+    vec2 scrSize;
+};
 
 float random(float x)
 {
     return fract(sin(x) * 100.);
 }
 
+float circleIn(float x)
+{
+    return 1. - sqrt(1. - x * x);
+}
+
+mat3 rotationY(float a)
+{
+    return mat3(cos(a), 0., -sin(a), 0., 1., 0., sin(a), 0., cos(a));
+}
+
+mat3 rotationX(float a)
+{
+    return mat3(1., 0., 0., 0., cos(a), sin(a), 0., -sin(a), cos(a));
+}
+
 void main()
 {
-    float nr = float(gl_InstanceID);
+    int particle = gl_InstanceID % PARTICLES_PER_CLOUD;
+    if (float(particle) >= cloudLife.z)
+    {
+        // unused instance of a small cloud, outside the clip volume
+        gl_Position = vec4(2., 2., 2., 1.);
+        opacity = 0.;
+        return;
+    }
+    float nr = float(particle);
+    vec3 spawnPoint = spawnPoints[particle / PARTICLES_PER_SPAWNPOINT];
+
+    float age = time - cloudLife.x;
+    float lon = cloudPath.x + age * cloudPath.z;
+    float lat = cloudPath.y + age * cloudPath.w;
+    mat3 rotation = rotationY(radians(lon)) * rotationX(radians(lat));
+
+    // camera axes in cloud space
+    vec3 cloudUp = up * rotation, cloudRight = right * rotation;
 
     vec3 pos = vec3(0);
-    if (a_pos.x > 0.) pos += right;
-    else pos -= right;
-    if (a_pos.y > 0.) pos += up;
-    else pos -= up;
+    if (a_pos.x > 0.) pos += cloudRight;
+    else pos -= cloudRight;
+    if (a_pos.y > 0.) pos += cloudUp;
+    else pos -= cloudUp;
 
     float size = (random(nr + 100.) + .5) * 90.;
     pos *= size;
@@ -50,12 +94,18 @@ void main()
     v_texCoords.y += (random(nr + 30.) - .5) * time * .04;
 
     pos *= .05; // scale
-    gl_Position = (mvp * vec4(pos, 1));
+    gl_Position = mvp * vec4(rotation * (pos + vec3(0., cloudDistance, 0.)), 1.);
     // fade out when camera comes too close:
     opacity *= min(1., gl_Position.z * .002);
     // fade the entire cloud in and out:
+    float cloudOpacity = circleIn(clamp(min(cloudLife.y - time, age) / 20., 0., 1.));
     opacity *= min(1., cloudOpacity * (1. + 8. * random(nr)));
 
+    // darker near the poles and on the night side
+    float light = 1. - circleIn(min(1., abs(lat / 30.)));
+    light += 1. - circleIn(min(1., abs((180. - lat) / 30.)));
+    light += clamp(dot(vec3(sin(radians(lon)), 0., cos(radians(lon))), sunDir) + .8, 0., 1.);
+
     cloudColor = vec3(1.8 * light, 1.3 * light, light) + vec3(.3 + random(nr + 3.) * .2);
     cloudColor.r = min(1., max(0., cloudColor.r));
     cloudColor.g = min(1., max(0., cloudColor.g));
@@ -5,12 +5,12 @@ precision mediump sampler2DArray;
 out vec4 color;
 
 in vec2 v_texCoords;
+in vec4 v_color;
+flat in int v_layer;
 
 uniform sampler2DArray textures;
-uniform vec4 flareColor;
-uniform int layer;
 
 void main()
 {
-    color = flareColor * texture(textures, vec3(v_texCoords, layer)) * flareColor.a;
+    color = v_color * texture(textures, vec3(v_texCoords, v_layer)) * v_color.a;
 }
@@ -0,0 +1,69 @@
+#version 330 core
+precision mediump float;
+
+layout(location = 0) in vec3 a_pos;
+
+// per flare attributes:
+layout(location = 1) in vec4 flareColor;
+layout(location = 2) in vec4 flareShape; // texture layer, scale, distance along the sun axis, rotate (0 or 1)
+
+out vec2 v_texCoords;
+out vec4 v_color;
+flat out int v_layer;
+
+uniform sampler2D sceneDepth;
+uniform vec2 sunScreenPosition; // normalized device coordinates
+uniform float sunDepth; // window depth of the front of the sun
+uniform float flareIntensity, flareRotation;
+
+layout(std140) uniform PerFrame {
+    vec3 sunDir;
+    float time;
+    vec2 scrSize;
+};
+
+// Fraction of a small area around the sun that is not covered by something in front of it
+float sunVisibility()
+{
+    const int TAPS = 3; // per side of the square, (2 * TAPS + 1)^2 samples
+    const float SPREAD = .008; // between 2 taps, in texture coordinates along y
+
+    vec2 center = sunScreenPosition * .5 + .5;
+    vec2 step = vec2(SPREAD * scrSize.y / scrSize.x, SPREAD);
+
+    float visible = 0.;
+    for (int x = -TAPS; x <= TAPS; x++)
+    {
+        for (int y = -TAPS; y <= TAPS; y++)
+        {
+            vec2 tap = center + vec2(x, y) * step;
+            if (any(lessThan(tap, vec2(0.))) || any(greaterThan(tap, vec2(1.)))) continue;
+
+            // sky and the sun itself are at or behind the sun
+            if (textureLod(sceneDepth, tap, 0.).r >= sunDepth) visible += 1.;
+        }
+    }
+    float taps = float((2 * TAPS + 1) * (2 * TAPS + 1));
+    return visible / taps;
+}
+
+void main()
+{
+    vec2 pos = a_pos.xy;
+    if (flareShape.w > .5)
+    {
+        float c = cos(flareRotation), s = sin(flareRotation);
+        pos = mat2(c, s, -s, c) * pos;
+    }
+    pos.x *= scrSize.y / scrSize.x;
+
+    float scale = flareShape.y;
+    gl_Position = vec4(pos * scale + sunScreenPosition * flareShape.z, scale, 1.);
+
+    float visibility = sunVisibility();
+    v_color = flareColor;
+    v_color.a *= visibility * visibility * flareIntensity;
+
+    v_texCoords = a_pos.xy * vec2(.5) + vec2(.5);
+    v_layer = int(flareShape.x);
+}
@@ -2,11 +2,18 @@
 
 layout(location = 0) in vec3 a_vertex;
 
-uniform mat4 MVP;
+layout(std140) uniform PerView {
+    mat4 viewProjection;
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];
+    vec4 cascadeSplits;
+    vec3 camPos;
+};
 
 out vec3 v_normal;
 
 void main()
 {
-    gl_Position = MVP * vec4(a_vertex, 1);
+    gl_Position = viewProjection * vec4(a_vertex, 1);
 }
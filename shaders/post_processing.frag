@@ -5,33 +5,14 @@ out vec4 color;
 
 in vec2 v_texCoords;
 
+// output of the previous effect in the post chain, the zoom blur when it is active
 uniform sampler2D scene;
-uniform vec2 resolution;
-uniform float zoomEffect;
 
 uniform sampler2D sceneDepth;
 uniform float zoom;
 
 const float near = .1, far = 2000.;
 
-void zoomMotionBlur()
-{
-    vec2 mbOffset = vec2(gl_FragCoord.x / resolution.x, gl_FragCoord.y / resolution.y) - vec2(.5);
-    if (zoomEffect > .05)
-    {
-        const int steps = 20;
-        float div = 1.;
-
-        for (int i = 0; i < steps; i++)
-        {
-            float effect = 1. - float(i) / float(steps);
-            div += effect;
-            color += texture(scene, v_texCoords - mbOffset * .09 * zoomEffect * (float(i) / float(steps))) * effect;
-        }
-        color /= div;
-    }
-}
-
 void fog()
 {
     float depth = texture(sceneDepth, v_texCoords).r;
@@ -59,8 +40,6 @@ void main()
 
     color = vec4(r, g, b, 1);
 
-    zoomMotionBlur();
-
     fog();
 
     float vignette = smoothstep(3.0, .6, length(offset));
@@ -1,9 +1,20 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 MVP;
+#ifndef MULTI_DRAW
+uniform mat4 model;
+#endif
+
+layout(std140) uniform PerView {
+    mat4 viewProjection;
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];
+    vec4 cascadeSplits;
+    vec3 camPos;
+};
 
 void main()
 {
-    gl_Position = MVP * vec4(aPos, 1.0);
+    gl_Position = viewProjection * model * vec4(aPos, 1.0);
 } 
\ No newline at end of file
@@ -3,12 +3,19 @@ layout(location = 0) in vec3 a_pos;
 
 out vec3 v_texCoords;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout(std140) uniform PerView {
+    mat4 viewProjection;
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];
+    vec4 cascadeSplits;
+    vec3 camPos;
+};
 
 void main()
 {
     v_texCoords = a_pos;
-    gl_Position = (projection * view * vec4(a_pos, 1.0)).xyww;
+    // Without the translation of the view, the box stays around the camera
+    gl_Position = (projection * mat4(mat3(view)) * vec4(a_pos, 1.0)).xyww;
     // gl_Position = viewProjection * vec4(a_pos, 1.0);
 }
@@ -8,9 +8,20 @@ layout(location = 3) in vec3 a_tangent;
 
 out vec2 v_texCoord;
 
-uniform mat4 MVP;
+#ifndef MULTI_DRAW
+uniform mat4 model;
+#endif
+
+layout(std140) uniform PerView {
+    mat4 viewProjection;
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];
+    vec4 cascadeSplits;
+    vec3 camPos;
+};
 
 void main(void) {
-    gl_Position = MVP * vec4(a_pos, 1.0);
+    gl_Position = viewProjection * model * vec4(a_pos, 1.0);
     v_texCoord = a_texCoords;
 }
\ No newline at end of file
@@ -14,19 +14,48 @@ in float v_y;
 
 in float v_shadowOpacity;
 
-in vec4 shadowMapCoords;
+in vec3 v_worldPos;
+in float v_viewDepth;
 
 out vec4 color;
 
-uniform vec3 sunDir;
-uniform float time;
+layout(std140) uniform PerFrame {
+    vec3 sunDir;
+    float time;
+    vec2 scrSize;
+};
+
+layout(std140) uniform PerView {
+    mat4 viewProjection;
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];
+    vec4 cascadeSplits;
+    vec3 camPos;
+};
+
 uniform sampler2DArray terrainTextures;
 // uniform sampler2D grassTexture;
 uniform int backgroundTerrainLayer;
 uniform vec4 terrainLayers, specularity, textureScale;
 uniform ivec4 hasNormal, fadeBlend;
 
-uniform highp sampler2DShadow shadowBuffer;
+uniform highp sampler2DArrayShadow shadowBuffer;
+
+// Position in the shadow map of the cascade that covers this fragment, cascade is -1 beyond the last cascade
+vec4 shadowCoords(out float cascade)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        if (v_viewDepth < cascadeSplits[i])
+        {
+            cascade = float(i);
+            return shadowMatrices[i] * vec4(v_worldPos, 1);
+        }
+    }
+    cascade = -1.;
+    return vec4(-1.);
+}
 
 // Returns a random number based on a vec3 and an int.
 float random(vec3 seed, int i){
@@ -118,7 +147,9 @@ void main() {
     float diffuseLight = dot(normal, v_sunDirTanSpace) * lightEffect + (1. - lightEffect);
     color.rgb *= diffuseLight;
 
-    if (shadowMapCoords.x >= 0. && shadowMapCoords.x <= 1. && shadowMapCoords.y >= 0. && shadowMapCoords.y <= 1.)
+    float cascade;
+    vec4 shadowMapCoords = shadowCoords(cascade);
+    if (cascade >= 0. && shadowMapCoords.x >= 0. && shadowMapCoords.x <= 1. && shadowMapCoords.y >= 0. && shadowMapCoords.y <= 1.)
     {
         float cosTheta = clamp( dot( normal, sunDir ), 0, 1);
 
@@ -138,7 +169,7 @@ void main() {
             
             // being fully in the shadow will eat up 4*0.2 = 0.8
             // 0.2 potentially remain, which is quite dark.
-            shadow -= 0.2*(1.0-texture( shadowBuffer, vec3(shadowMapCoords.xy + poissonDisk[index]/700.0,  (shadowMapCoords.z-bias)/shadowMapCoords.w) ));
+            shadow -= 0.2*(1.0-texture( shadowBuffer, vec4(shadowMapCoords.xy + poissonDisk[index]/700.0, cascade, (shadowMapCoords.z-bias)/shadowMapCoords.w) ));
         }
 
         // float shadow = texture(shadowBuffer, shadowMapCoords.xyz);
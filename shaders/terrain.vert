@@ -8,11 +8,28 @@ layout(location = 3) in vec3 a_tangent;
 layout(location = 4) in vec4 a_texBlend;
 layout(location = 5) in float a_y;
 
-uniform mat4 MVP;
-uniform vec3 sunDir;
-
-uniform mat4 shadowMatrix;
-out vec4 shadowMapCoords;
+#ifndef MULTI_DRAW
+uniform mat4 model;
+#endif
+
+layout(std140) uniform PerFrame {
+    vec3 sunDir;
+    float time;
+    vec2 scrSize;
+};
+
+layout(std140) uniform PerView {
+    mat4 viewProjection;
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];
+    vec4 cascadeSplits;
+    vec3 camPos;
+};
+
+// World position and depth in the view of the camera, to pick and sample a shadow cascade
+out vec3 v_worldPos;
+out float v_viewDepth;
 
 out vec3 v_pos;
 out vec2 v_texCoord;
@@ -28,13 +45,17 @@ out float v_dayLight;
 
 
 void main() {
+    mat4 MVP = viewProjection * model;
+
     v_pos = a_pos;
     gl_Position = MVP * vec4(a_pos, 1);
     v_texCoord = a_texCoords * 4.;
     v_texBlend = a_texBlend;
     v_y = a_y;
 
-    shadowMapCoords = shadowMatrix * vec4(a_pos, 1);
+    vec4 worldPos = model * vec4(a_pos, 1);
+    v_worldPos = worldPos.xyz;
+    v_viewDepth = -(view * worldPos).z;
 
     vec3 up = a_normal;
     vec3 tan = a_tangent;
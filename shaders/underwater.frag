@@ -7,10 +7,14 @@ in float v_y;
 
 out vec4 color;
 
-uniform vec3 sunDir;
+layout(std140) uniform PerFrame {
+    vec3 sunDir;
+    float time;
+    vec2 scrSize;
+};
+
 uniform sampler2D causticsSheet;
 uniform sampler2D terrainTexture;
-uniform float time;
 
 const float near = .1, far = 1000.;
 
@@ -12,19 +12,46 @@ in vec3 v_toCamera;
 in mat3 v_fromTanSpace;
 in float v_shadowOpacity;
 
-in vec4 shadowMapCoords;
+in vec3 v_worldPos;
+in float v_viewDepth;
+
+layout(std140) uniform PerFrame {
+    vec3 sunDir;
+    float time;
+    vec2 scrSize;
+};
+
+layout(std140) uniform PerView {
+    mat4 viewProjection;
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];
+    vec4 cascadeSplits;
+    vec3 camPos;
+};
 
-uniform vec3 sunDir;
 uniform sampler2D foamTexture;
 uniform sampler2D seaWaves;
 uniform sampler2D underwaterTexture;
 uniform sampler2D underwaterDepthTexture;
 // uniform sampler2D reflectionTexture;
 
-uniform highp sampler2DShadow shadowBuffer;
+uniform highp sampler2DArrayShadow shadowBuffer;
 
-uniform float time;
-uniform vec2 scrSize;
+// Position in the shadow map of the cascade that covers this fragment, cascade is -1 beyond the last cascade
+vec4 shadowCoords(out float cascade)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        if (v_viewDepth < cascadeSplits[i])
+        {
+            cascade = float(i);
+            return shadowMatrices[i] * vec4(v_worldPos, 1);
+        }
+    }
+    cascade = -1.;
+    return vec4(-1.);
+}
 
 const float pole = .2, poleMargin = .1, near = .1, far = 1000.;
 
@@ -327,7 +354,9 @@ void main()
 
 
     float shadow = 1.; // was 0
-    if (v_shadowOpacity > 0. && shadowMapCoords.x >= 0. && shadowMapCoords.x <= 1. && shadowMapCoords.y >= 0. && shadowMapCoords.y <= 1.)
+    float cascade;
+    vec4 shadowMapCoords = shadowCoords(cascade);
+    if (v_shadowOpacity > 0. && cascade >= 0. && shadowMapCoords.x >= 0. && shadowMapCoords.x <= 1. && shadowMapCoords.y >= 0. && shadowMapCoords.y <= 1.)
     {
        float cosTheta = clamp( dot( normal, sunDir ), 0, 1);
 
@@ -345,7 +374,7 @@ void main()
             
             // being fully in the shadow will eat up 4*0.2 = 0.8
             // 0.2 potentially remain, which is quite dark.
-            shadow -= 0.2*(1.0-texture( shadowBuffer, vec3(shadowMapCoords.xy + poissonDisk[index]/700.0,  (shadowMapCoords.z-bias)/shadowMapCoords.w) ));
+            shadow -= 0.2*(1.0-texture( shadowBuffer, vec4(shadowMapCoords.xy + poissonDisk[index]/700.0, cascade, (shadowMapCoords.z-bias)/shadowMapCoords.w) ));
         }
 
         float shadowOpacity = v_shadowOpacity * .3;
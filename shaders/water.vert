@@ -6,11 +6,24 @@ layout(location = 1) in vec3 a_normal;
 layout(location = 2) in vec2 a_texCoords;
 layout(location = 3) in vec3 a_tangent;
 
-uniform mat4 MVP;
-uniform vec3 camPos;
-uniform vec3 sunDir;
-uniform float time;
-uniform mat4 shadowMatrix;
+#ifndef MULTI_DRAW
+uniform mat4 model;
+#endif
+
+layout(std140) uniform PerFrame {
+    vec3 sunDir;
+    float time;
+    vec2 scrSize;
+};
+
+layout(std140) uniform PerView {
+    mat4 viewProjection;
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];
+    vec4 cascadeSplits;
+    vec3 camPos;
+};
 
 out vec3 v_pos;
 out vec3 v_normal;
@@ -22,7 +35,9 @@ out vec3 v_toCamera;
 out mat3 v_fromTanSpace;
 out float v_shadowOpacity;
 
-out vec4 shadowMapCoords;
+// World position and depth in the view of the camera, to pick and sample a shadow cascade
+out vec3 v_worldPos;
+out float v_viewDepth;
 
 vec3 mod289(vec3 x) {
     return x - floor(x * (1.0 / 289.0)) * 289.0;
@@ -117,6 +132,8 @@ float snoise(vec3 v) {
 
 void main()
 {
+    mat4 MVP = viewProjection * model;
+
     v_pos = a_pos;
     gl_Position = MVP * vec4(a_pos, 1); // temporary
     float waveMultiplier = max(.1, min(1., 1. - (gl_Position.z - 20.) / 100.));
@@ -127,7 +144,9 @@ void main()
     v_tangent = a_tangent;
     v_texCoords = a_texCoords;
 
-    shadowMapCoords = shadowMatrix * vec4(pos, 1);
+    vec4 worldPos = model * vec4(pos, 1);
+    v_worldPos = worldPos.xyz;
+    v_viewDepth = -(view * worldPos).z;
 
     vec3 up = a_normal;
     vec3 tan = a_tangent;
@@ -0,0 +1,25 @@
+#version 330 core
+precision mediump float;
+
+out vec4 color;
+
+in vec2 v_texCoords;
+
+uniform sampler2D scene;
+uniform float zoomEffect;
+
+void main()
+{
+    vec2 mbOffset = v_texCoords - vec2(.5);
+    const int steps = 20;
+    float div = 1.;
+
+    color = texture(scene, v_texCoords);
+    for (int i = 0; i < steps; i++)
+    {
+        float effect = 1. - float(i) / float(steps);
+        div += effect;
+        color += texture(scene, v_texCoords - mbOffset * .09 * zoomEffect * (float(i) / float(steps))) * effect;
+    }
+    color /= div;
+}
@@ -0,0 +1,149 @@
+#include "climate.hpp"
+
+// Standard Headers
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <glm/glm.hpp>
+
+// Local Headers
+#include "planet.hpp"
+#include "utils/math_utils.h"
+
+namespace {
+    // Degrees per second at the equator
+    const float WIND_SPEED = 1.f;
+
+    // Fraction of the gap to the target humidity that evaporates per second
+    const float EVAPORATION = .05f, LAND_EVAPORATION = .005f;
+
+    // Fraction of the condensed humidity that rains out per second
+    const float PRECIPITATION = .02f;
+
+    // Degrees of temperature lost per unit of elevation
+    const float LAPSE_RATE = 1.5f;
+}
+
+Climate::Climate(const Planet &planet, unsigned int lonCells)
+    : lonCells(lonCells), latCells(std::max(1u, lonCells / 2))
+{
+    unsigned int cells = nrOfCells();
+
+    std::vector<glm::vec2> lonLats(cells);
+    for (unsigned int cell = 0; cell < cells; cell++)
+        lonLats[cell] = glm::vec2((cell % lonCells + .5f) * 360.f / lonCells, (cell / lonCells + .5f) * 180.f / latCells);
+
+    std::vector<float> elevations;
+    planet.heightAt(lonLats, elevations);
+
+    temperature.resize(cells);
+    saturation.resize(cells);
+    ocean.resize(cells);
+    winds.resize(cells);
+    humidity.resize(cells);
+    density.assign(cells, 0.f);
+
+    for (unsigned int cell = 0; cell < cells; cell++)
+    {
+        float lat = lonLats[cell].y;
+        float polar = lat * mu::DEGREES_TO_RAD;
+
+        // Angle from the equator, positive on the northern half
+        float geographic = (90.f - lat) * mu::DEGREES_TO_RAD;
+
+        temperature[cell] = -20.f + 48.f * std::sin(polar) - LAPSE_RATE * std::max(0.f, elevations[cell]);
+        saturation[cell] = .1f + .9f * glm::clamp((temperature[cell] + 30.f) / 60.f, 0.f, 1.f);
+        ocean[cell] = elevations[cell] < 0;
+
+        // Three cells per half: easterlies around the equator and the poles, westerlies in between,
+        // with the surface flow of the cells towards the equator and the poles.
+        float zonal = -std::cos(6.f * std::abs(geographic));
+        float meridional = .3f * std::sin(6.f * std::abs(geographic)) * (geographic > 0 ? 1.f : -1.f);
+
+        // Same ground speed at every latitude, a degree of longitude is shorter near the poles
+        winds[cell] = WIND_SPEED * glm::vec2(zonal / std::max(.2f, std::sin(polar)), meridional);
+
+        humidity[cell] = saturation[cell] * (ocean[cell] ? .9f : .4f);
+    }
+    nextHumidity = humidity;
+
+    std::atomic_store(&publishedDensity, std::shared_ptr<const std::vector<float>>(new std::vector<float>(density)));
+}
+
+unsigned int Climate::advance(unsigned int maxCells)
+{
+    if (!stepping)
+    {
+        if (pendingTime <= 0) return 0;
+
+        stepTime = std::min(pendingTime, MAX_STEP);
+        pendingTime = 0;
+        nextCell = 0;
+        stepping = true;
+    }
+
+    unsigned int end = std::min(nrOfCells(), nextCell + maxCells);
+    unsigned int simulated = end - nextCell;
+
+    for (; nextCell < end; nextCell++) simulateCell(nextCell);
+
+    if (nextCell == nrOfCells())
+    {
+        humidity.swap(nextHumidity);
+        std::atomic_store(&publishedDensity, std::shared_ptr<const std::vector<float>>(new std::vector<float>(density)));
+        stepping = false;
+    }
+    return simulated;
+}
+
+void Climate::simulateCell(unsigned int cell)
+{
+    float lon = (cell % lonCells + .5f) * 360.f / lonCells;
+    float lat = (cell / lonCells + .5f) * 180.f / latCells;
+
+    // The air in this cell came from upwind
+    const glm::vec2 &w = winds[cell];
+    float h = sample(humidity, lon - w.x * stepTime, glm::clamp(lat - w.y * stepTime, 0.f, 180.f));
+
+    float sat = saturation[cell];
+
+    // Warm seas keep the air slightly oversaturated, land dries it out
+    float target = sat * (ocean[cell] ? 1.1f : .6f);
+    float rate = std::min(1.f, (ocean[cell] ? EVAPORATION : LAND_EVAPORATION) * stepTime);
+    h += (target - h) * rate;
+
+    float condensed = std::max(0.f, h - sat);
+    h -= condensed * std::min(1.f, PRECIPITATION * stepTime);
+
+    nextHumidity[cell] = h;
+    density[cell] = glm::clamp(condensed / (.25f * sat), 0.f, 1.f);
+}
+
+float Climate::sample(const std::vector<float> &grid, float lon, float lat) const
+{
+    float x = lon / 360.f * lonCells - .5f;
+    float y = glm::clamp(lat / 180.f * latCells - .5f, 0.f, latCells - 1.f);
+
+    float x0 = std::floor(x), y0 = std::floor(y);
+    float fx = x - x0, fy = y - y0;
+
+    unsigned int col0 = ((int) x0 % (int) lonCells + lonCells) % lonCells, col1 = (col0 + 1) % lonCells;
+    unsigned int row0 = y0, row1 = std::min(row0 + 1, latCells - 1);
+
+    float top = glm::mix(grid[row0 * lonCells + col0], grid[row0 * lonCells + col1], fx);
+    float bottom = glm::mix(grid[row1 * lonCells + col0], grid[row1 * lonCells + col1], fx);
+    return glm::mix(top, bottom, fy);
+}
+
+float Climate::cloudDensity(float lon, float lat) const
+{
+    std::shared_ptr<const std::vector<float>> snapshot = std::atomic_load(&publishedDensity);
+    return sample(*snapshot, lon, lat);
+}
+
+glm::vec2 Climate::wind(float lon, float lat) const
+{
+    unsigned int col = std::min(lonCells - 1, (unsigned int) (glm::mod(lon, 360.f) / 360.f * lonCells));
+    unsigned int row = std::min(latCells - 1, (unsigned int) (glm::clamp(lat, 0.f, 180.f) / 180.f * latCells));
+    return winds[row * lonCells + col];
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+// Standard Headers
+#include <memory>
+#include <vector>
+#include <glm/vec2.hpp>
+
+class Planet;
+
+/**
+ * Coarse climate of a planet on a longitude/latitude grid, in the lon/lat convention of Planet
+ * (latitude 0 is the north pole, 180 the south pole).
+ *
+ * Temperature follows from the latitude and the elevation of the terrain and does not change.
+ * Humidity is carried along by a fixed three cell wind field (semi-Lagrangian advection),
+ * evaporates over the oceans and condenses where the air is colder than it can hold, so clouds
+ * form over warm seas and in front of mountains. The condensed part is the cloud density.
+ *
+ * A step over the whole grid is split into slices by advance(), so the WeatherSimulation worker
+ * can spread it over multiple frames. Every cell costs the same, a step is linear in the number of cells.
+ * The cloud density of the last completed step is published as an immutable snapshot,
+ * the render thread reads it without waiting for the worker.
+ */
+class Climate
+{
+  public:
+    /**
+     * Samples the elevation of the planet, so its height map has to be generated already.
+     */
+    Climate(const Planet &planet, unsigned int lonCells);
+
+    unsigned int nrOfCells() const { return lonCells * latCells; }
+
+    /**
+     * Worker thread only. Adds simulated time, it is consumed by the next step.
+     */
+    void addTime(float dt) { pendingTime += dt; }
+
+    /**
+     * Worker thread only. Simulates at most maxCells cells of the current step, returns the number of cells simulated.
+     * Starts a new step when the last one is done and there is pending time.
+     */
+    unsigned int advance(unsigned int maxCells);
+
+    /**
+     * Cloud density between 0 and 1 at the end of the last step, thread safe.
+     */
+    float cloudDensity(float lon, float lat) const;
+
+    /**
+     * Wind in degrees of longitude and latitude per second, thread safe.
+     */
+    glm::vec2 wind(float lon, float lat) const;
+
+  private:
+    // Simulated seconds per step at most, the rest of a long frame is dropped
+    static constexpr float MAX_STEP = 5.f;
+
+    unsigned int lonCells, latCells;
+
+    // Per cell, do not change after construction
+    std::vector<float> temperature, saturation;
+    std::vector<bool> ocean;
+    std::vector<glm::vec2> winds;
+
+    // Humidity of the last step and the one being simulated
+    std::vector<float> humidity, nextHumidity;
+    std::vector<float> density;
+
+    std::shared_ptr<const std::vector<float>> publishedDensity;
+
+    float pendingTime = 0, stepTime = 0;
+    unsigned int nextCell = 0;
+    bool stepping = false;
+
+    /**
+     * Bilinear sample of a per cell value, wraps around in longitude.
+     */
+    float sample(const std::vector<float> &grid, float lon, float lat) const;
+
+    void simulateCell(unsigned int cell);
+};
+
+typedef std::shared_ptr<Climate> SharedClimate;
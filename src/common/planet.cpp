@@ -19,9 +19,14 @@ Planet::Planet(PlanetConfig config): name(config.name), config(config), OrbitalM
 
 void Planet::upload()
 {
-    VertBuffer::uploadSingleMesh(terrainMesh);
-    VertBuffer::uploadSingleMesh(waterMesh);
-    VertBuffer::uploadSingleMesh(atmosphereMesh);
+    _model_bbox = terrainMesh->computeBounds();
+    bounding_box box = waterMesh->computeBounds();
+    _model_bbox.min = glm::min(_model_bbox.min, box.min);
+    _model_bbox.max = glm::max(_model_bbox.max, box.max);
+
+    // Uploaded by VertBuffer::uploadShared(), together with the meshes of the other planets
+    VertBuffer::addShared(terrainMesh);
+    VertBuffer::addShared(waterMesh);
 }
 
 void Planet::uploadOrbit() {
@@ -53,7 +58,7 @@ void Planet::uploadOrbit() {
         orbitMesh->indices[i] = i;
     }
 
-    VertBuffer::uploadSingleMesh(orbitMesh);
+    VertBuffer::addShared(orbitMesh);
 }
 
 void Planet::update(float time) {
@@ -62,21 +67,19 @@ void Planet::update(float time) {
 
 void Planet::render(RenderType type)
 {
-    if (type == RenderType::Terrain) {
-        terrainMesh->render();
-    }
-
-    if (type == RenderType::Water) {
-        waterMesh->render();
-    }
-
-    if (type == RenderType::Path) {
-        if (center) orbitMesh->render();
-    }
+    Mesh * mesh = get_mesh(type);
+    if (mesh) mesh->render();
+}
 
-    if (type == RenderType::Atmosphere) {
-        atmosphereMesh->render();
+Mesh * Planet::get_mesh(RenderType type)
+{
+    switch (type)
+    {
+        case RenderType::Terrain: return terrainMesh.get();
+        case RenderType::Water: return waterMesh.get();
+        case RenderType::Path: return center ? orbitMesh.get() : nullptr;
     }
+    return nullptr;
 }
 
 float Planet::longitude(float x, float z) const
@@ -108,16 +111,78 @@ vec2 Planet::deltaLonLat(vec2 a, vec2 b)
 
 bool Planet::rayToLonLat(const glm::vec3 &rayOrigin, const glm::vec3 &rayDirection, glm::vec2 &lonLat)
 {
-    glm::vec3 intersection, normal;
+    TerrainHit hit;
+    if (!raycastTerrain(rayOrigin, rayDirection, hit)) return false;
+
+    lonLat = hit.lonLat;
+    return true;
+}
+
+glm::vec3 Planet::lonLatToDirection(float lon, float lat) const
+{
+    // Inverse of longitude() and latitude()
+    float theta = lat * mu::DEGREES_TO_RAD, phi = (lon - 180.f) * mu::DEGREES_TO_RAD;
+    return glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+}
+
+float Planet::heightAt(float lon, float lat) const
+{
+    if (!heightMap) return 0;
+    return heightMap->radiusAt(lonLatToDirection(lon, lat)) - config.radius;
+}
+
+void Planet::heightAt(const std::vector<glm::vec2> &lonLats, std::vector<float> &heights) const
+{
+    heights.assign(lonLats.size(), 0.f);
+    if (!heightMap) return;
+
+    std::vector<glm::vec3> directions(lonLats.size());
+    for (unsigned int i = 0; i < lonLats.size(); i++)
+        directions[i] = lonLatToDirection(lonLats[i].x, lonLats[i].y);
+
+    heightMap->radiusAt(directions, heights);
+    for (float &height : heights) height -= config.radius;
+}
+
+bool Planet::raycastTerrain(const glm::vec3 &origin, const glm::vec3 &direction, TerrainHit &hit, float maxDistance)
+{
     const glm::vec3 & position = this->get_position();
-    if (glm::intersectRaySphere(rayOrigin, rayDirection, position, config.radius, intersection, normal))
+    glm::vec3 localOrigin = origin - position;
+
+    if (heightMap)
     {
-        intersection -= position;
-        lonLat.x = longitude(intersection.x, intersection.z);
-        lonLat.y = latitude(intersection.y);
-        return true;
+        if (!heightMap->raycast(localOrigin, direction, hit, maxDistance)) return false;
     }
-    else return false;
+    else
+    {
+        glm::vec3 intersection, normal;
+        if (!glm::intersectRaySphere(localOrigin, glm::normalize(direction), glm::vec3(0.f), config.radius, intersection, normal))
+            return false;
+
+        hit.distance = glm::length(intersection - localOrigin);
+        if (hit.distance > maxDistance) return false;
+
+        hit.valid = true;
+        hit.position = intersection;
+        hit.normal = normal;
+    }
+
+    glm::vec3 up = glm::normalize(hit.position);
+    hit.lonLat.x = longitude(hit.position.x, hit.position.z);
+    hit.lonLat.y = mu::RAD_TO_DEGREES * glm::acos(glm::clamp(up.y, -1.f, 1.f));
+    hit.position += position;
+    return true;
+}
+
+unsigned int Planet::raycastTerrain(const std::vector<TerrainRay> &rays, std::vector<TerrainHit> &hits)
+{
+    hits.resize(rays.size());
+
+    unsigned int nrOfHits = 0;
+    for (unsigned int i = 0; i < rays.size(); i++)
+        if (raycastTerrain(rays[i].origin, rays[i].direction, hits[i])) nrOfHits++;
+
+    return nrOfHits;
 }
 
 glm::vec3 Planet::lonLatTo3d(float lon, float lat, float altitude) const
@@ -3,13 +3,17 @@
 // Standard Headers
 #include <iostream>
 #include <vector>
+#include <limits>
 #include <glm/vec2.hpp>
 
 // Local Headers
 #include "orbital_mass.hpp"
 #include "geometry/sphere.hpp"
+#include "geometry/terrain_height_map.hpp"
 #include "graphics/renderable.hpp"
 #include "graphics/camera.hpp"
+#include "graphics/atmosphere_lut.hpp"
+#include "common/climate.hpp"
 
 struct PlanetConfig {
     std::string name;
@@ -25,6 +29,11 @@ struct PlanetConfig {
     // Noise
     float roughness = 1;
 
+    // Longitude cells of the climate grid, it has half as many latitude cells
+    int climateCells = 64;
+
+    AtmosphereProfile atmosphere;
+
     OrbitalParameters orbit = {
         0.f, 0, 0, 0, 0
     };
@@ -41,9 +50,17 @@ class Planet: public OrbitalMass, public Renderable {
         
         SharedMesh terrainMesh;
         SharedMesh waterMesh;
-        SharedMesh atmosphereMesh;
         SharedMesh orbitMesh;
 
+        // Drawn by the AtmosphereRenderer, shared with planets that have the same radius and atmosphere
+        SharedAtmosphereLUT atmosphere;
+
+        // Built by the PlanetGenerator, used for terrain queries.
+        std::shared_ptr<TerrainHeightMap> heightMap;
+
+        // Built by the PlanetGenerator, simulated by the WeatherSimulation of the Universe.
+        SharedClimate climate;
+
         /**
          * Texture map of the planet.
          * An planet can have 5 textures.
@@ -66,6 +83,7 @@ class Planet: public OrbitalMass, public Renderable {
 
         void update(float time);
         void render(RenderType type);
+        Mesh * get_mesh(RenderType type);
 
         glm::vec3 calculatePointOnPlanet(glm::vec3 pointOnUnitSphere);
 
@@ -76,6 +94,24 @@ class Planet: public OrbitalMass, public Renderable {
         glm::vec3 lonLatTo3d(float lon, float lat, float altitude) const;
 
         bool rayToLonLat(const glm::vec3 &rayOrigin, const glm::vec3 &rayDirection, glm::vec2 &lonLat);
+
+        // Terrain queries, falls back to the sphere of config.radius when there is no height map yet.
+        glm::vec3 lonLatToDirection(float lon, float lat) const;
+
+        /**
+         * Height of the terrain above sea level (config.radius) at the given longitude and latitude.
+         */
+        float heightAt(float lon, float lat) const;
+        void heightAt(const std::vector<glm::vec2> &lonLats, std::vector<float> &heights) const;
+
+        /**
+         * Nearest intersection of a world space ray with the terrain.
+         * The hit is returned in world space.
+         */
+        bool raycastTerrain(const glm::vec3 &origin, const glm::vec3 &direction, TerrainHit &hit, float maxDistance = std::numeric_limits<float>::max());
+
+        // returns the number of rays that hit the terrain.
+        unsigned int raycastTerrain(const std::vector<TerrainRay> &rays, std::vector<TerrainHit> &hits);
         
         void toBinary(std::vector<uint8> &out) const;
 
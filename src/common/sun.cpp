@@ -15,9 +15,14 @@ void Sun::upload() {
         .add_(VertAttributes::TANGENT);
 
     sunMesh = shape.generate("sun", 100, 70, sunAttrs);
-    VertBuffer::uploadSingleMesh(sunMesh);
+    _model_bbox = sunMesh->computeBounds();
+    VertBuffer::addShared(sunMesh);
 }
 
 void Sun::render(RenderType type) {
     if (type == RenderType::Terrain) sunMesh->render();
+}
+
+Mesh * Sun::get_mesh(RenderType type) {
+    return type == RenderType::Terrain ? sunMesh.get() : nullptr;
 }
\ No newline at end of file
@@ -17,4 +17,5 @@ class Sun: public OrbitalMass, public Renderable {
 
         void upload();
         void render(RenderType type);
+        Mesh * get_mesh(RenderType type);
 };
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include "utils/math_utils.h"
 #include "utils/orbital_utils.h"
 #include "utils/file/file.h"
+#include "graphics/vert_buffer.hpp"
+#include "graphics/profiler.hpp"
 
 #include "utils/generation/planet_generator.hpp"
 #include "graphics/input/key_input.hpp"
@@ -71,6 +73,9 @@ Universe::Universe() {
     generateOrbitalData();
     earth->uploadOrbit();
     earth2->uploadOrbit();
+
+    // All meshes with the same attributes end up in one VertBuffer
+    VertBuffer::uploadShared();
 }
 
 
@@ -85,6 +90,7 @@ void Universe::generateOrbitalData() {
 }
 
 void Universe::update(float dt) {
+    Profiler::CpuScope profile("Universe::update");
 
     simulationSpeed *= (KeyInput::justPressed(GLFW_KEY_KP_ADD) ? 2 : (KeyInput::justPressed(GLFW_KEY_KP_SUBTRACT) ? .5 : 1));
     simulationDt = simulationSpeed * dt;
@@ -94,6 +100,7 @@ void Universe::update(float dt) {
     if (Globals::scene->selected && KeyInput::justPressed(GLFW_KEY_R))
     {
         generator.generate(Globals::scene->selected);
+        VertBuffer::uploadShared();
         debugOpen = true;
     }
 
@@ -104,6 +111,10 @@ void Universe::update(float dt) {
         planets[i]->update(simulationTime);
     }
 
+    climates.clear();
+    for (Planet * planet : planets) if (planet->climate) climates.push_back(planet->climate);
+    weather.update(simulationDt, climates);
+
     if (debugOpen) PlanetGenerator::ShowDebugWindow(&debugOpen);
 }
 
@@ -3,6 +3,7 @@
 #include "orbital_mass.hpp"
 #include "sun.hpp"
 #include "planet.hpp"
+#include "weather_simulation.hpp"
 #include "utils/generation/planet_generator.hpp"
 
 class Universe {
@@ -12,6 +13,8 @@ class Universe {
         float simulationSpeed = 1.f;
 
         PlanetGenerator generator;
+        WeatherSimulation weather;
+        std::vector<SharedClimate> climates;
 
         std::vector<Sun *> suns;
         std::vector<Planet *> planets;
@@ -23,6 +26,10 @@ class Universe {
         void generateOrbitalData();
     public:
         Universe();
+
+        // Owns the generator and all bodies, pass it around by reference (see Scene::getUniverse)
+        Universe(const Universe &) = delete;
+        Universe & operator=(const Universe &) = delete;
         
         double getTime() const { return simulationTime; }
         double getDeltaTime() const { return simulationDt; }
@@ -0,0 +1,68 @@
+#include "weather_simulation.hpp"
+
+// Local Headers
+#include "graphics/profiler.hpp"
+
+WeatherSimulation::WeatherSimulation()
+{
+    worker = std::thread(&WeatherSimulation::run, this);
+}
+
+WeatherSimulation::~WeatherSimulation()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void WeatherSimulation::update(float dt, const std::vector<SharedClimate> &climates)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->climates = climates;
+        pendingTime += dt;
+        frameReady = true;
+    }
+    wake.notify_one();
+}
+
+void WeatherSimulation::run()
+{
+    std::vector<SharedClimate> frameClimates;
+
+    while (true)
+    {
+        float dt;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return frameReady || stop; });
+            if (stop) return;
+
+            // The copies keep a climate alive when the planet is regenerated during the frame
+            frameClimates = climates;
+            dt = pendingTime;
+            pendingTime = 0;
+            frameReady = false;
+        }
+
+        Profiler::CpuScope profile("WeatherSimulation::step");
+
+        for (const SharedClimate &climate : frameClimates) climate->addTime(dt);
+
+        // Round robin, so every planet gets its share of the budget when the grids are large
+        unsigned int budget = CELLS_PER_FRAME, idle = 0;
+        while (budget > 0 && !frameClimates.empty() && idle < frameClimates.size())
+        {
+            nextClimate %= frameClimates.size();
+            unsigned int simulated = frameClimates[nextClimate]->advance(budget);
+            if (simulated == 0) idle++;
+            else idle = 0;
+
+            budget -= simulated;
+            nextClimate++;
+        }
+    }
+}
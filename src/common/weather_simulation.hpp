@@ -0,0 +1,50 @@
+#pragma once
+
+// Standard Headers
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Local Headers
+#include "climate.hpp"
+
+/**
+ * Simulates the Climate of every planet on a worker thread.
+ *
+ * Every frame the worker simulates at most CELLS_PER_FRAME grid cells, spread over the planets,
+ * so a fine grid makes the weather evolve slower instead of making a frame longer.
+ * update() only hands over the frame time under a short lock, the render thread never waits for a step.
+ */
+class WeatherSimulation
+{
+  public:
+    static const unsigned int CELLS_PER_FRAME = 2048;
+
+    WeatherSimulation();
+    ~WeatherSimulation();
+
+    WeatherSimulation(const WeatherSimulation &) = delete;
+    WeatherSimulation & operator=(const WeatherSimulation &) = delete;
+
+    /**
+     * Render thread, once per frame. dt is the simulation time of the frame.
+     * climates replaces the set of simulated climates, a climate that is no longer in it is dropped.
+     */
+    void update(float dt, const std::vector<SharedClimate> &climates);
+
+  private:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    // Guarded by mutex
+    std::vector<SharedClimate> climates;
+    float pendingTime = 0;
+    bool frameReady = false, stop = false;
+
+    // Worker thread only
+    unsigned int nextClimate = 0;
+
+    void run();
+};
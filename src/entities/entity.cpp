@@ -32,9 +32,11 @@ void Entity::update(float dt) {
 			// }
 			
 			_origin += dt * get_velocity();
+			mark_dirty();
 		} else {
 			_origin.y = 0;
 			_speed = 0.f;
+			mark_dirty();
 		}
 	} else {
 		_speed = 0.f;
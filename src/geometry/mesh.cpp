@@ -4,6 +4,8 @@
 
 // Local Headers
 #include "graphics/vert_buffer.hpp"
+#include "graphics/gl_state.hpp"
+#include "utils/parallel.h"
 
 SharedMesh Mesh::quad;
 
@@ -52,6 +54,7 @@ void Mesh::render() {
         (void *)(uintptr_t)indicesBufferOffset,
         baseVertex
     );
+    GLState::countDraw();
     check_gl_error();
 }
 
@@ -71,39 +74,60 @@ void Mesh::renderInstances(GLsizei count)
         count,
         baseVertex
     );
+    GLState::countDraw();
 }
 
-void Mesh::computeSmoothingNormals() {
-    
-    std::vector<glm::vec3> smoothVertexNormals(nrOfVertices, glm::vec3(0.f));
+bounding_box Mesh::computeBounds() const {
+    bounding_box box = {glm::vec3(std::numeric_limits<float>::lowest()), glm::vec3(std::numeric_limits<float>::max())};
+
+    for (const glm::vec3 &p : view<glm::vec3>(attributes.getOffset(VertAttributes::POSITION)))
+    {
+        box.max = glm::max(box.max, p);
+        box.min = glm::min(box.min, p);
+    }
+    return box;
+}
 
+void Mesh::computeSmoothingNormals() {
     int position_offset = attributes.getOffset(VertAttributes::POSITION);
     int normal_offset = attributes.getOffset(VertAttributes::NORMAL);
 
-    for (size_t f = 0; f < indices.size() / 3; f++) {
-        int idx0 = indices[3 * f + 0];
-        int idx1 = indices[3 * f + 1];
-        int idx2 = indices[3 * f + 2];
+    const MeshTopology &topo = getTopology();
+    unsigned int nrOfTriangles = nrOfIndices / 3;
 
-        // Get the three indexes of the face (all faces are triangular)
-        glm::vec3 v1 = get<glm::vec3>(idx0, position_offset);
-        glm::vec3 v2 = get<glm::vec3>(idx1, position_offset);
-        glm::vec3 v3 = get<glm::vec3>(idx2, position_offset);
+    auto positions = view<const glm::vec3>(position_offset);
+    auto normals = view<glm::vec3>(normal_offset);
 
-        // Get the three vertex indexes and coordinates
-        glm::vec3 normal = glm::triangleNormal(v1, v2, v3);
+    // Face normals first, every triangle only writes its own normal
+    std::vector<glm::vec3> faceNormals(nrOfTriangles);
+    parallel::forEach(nrOfTriangles, [&](unsigned int f) {
+        faceNormals[f] = glm::triangleNormal(positions[indices[3 * f + 0]], positions[indices[3 * f + 1]], positions[indices[3 * f + 2]]);
+    });
 
-        // Add the normal to the three vertexes
-        smoothVertexNormals[idx0] += normal; 
-        smoothVertexNormals[idx1] += normal; 
-        smoothVertexNormals[idx2] += normal; 
+    // Then every vertex sums the normals of the faces around it
+    parallel::forEach(nrOfVertices, [&](unsigned int i) {
+        glm::vec3 normal(0.f);
+        for (unsigned int t = topo.triangleOffsets[i]; t < topo.triangleOffsets[i + 1]; t++)
+            normal += faceNormals[topo.vertexTriangles[t]];
 
-    }  // faces
+        normals[i] = glm::normalize(normal);
+    });
+}
 
-    // Normalize the normals, that is, make them unit vectors
-    for (size_t i = 0; i < smoothVertexNormals.size(); i++) {
-        set(glm::normalize(smoothVertexNormals[i]), i, normal_offset); 
+const MeshTopology &Mesh::getTopology()
+{
+    if (!topology || topologyNrOfIndices != nrOfIndices || topologyNrOfVertices != nrOfVertices)
+    {
+        topology = std::make_unique<MeshTopology>(indices.data(), nrOfIndices, nrOfVertices);
+        topologyNrOfIndices = nrOfIndices;
+        topologyNrOfVertices = nrOfVertices;
     }
+    return *topology;
+}
+
+void Mesh::invalidateTopology()
+{
+    topology.reset();
 }
 
 Mesh::~Mesh() {
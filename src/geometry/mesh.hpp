@@ -16,6 +16,7 @@
 // Local Headers
 #include "graphics/renderable.hpp"
 #include "graphics/vert_data.hpp"
+#include "geometry/mesh_topology.hpp"
 
 struct Material {
     float ambient[3];
@@ -56,8 +57,22 @@ class Mesh : public VertData {
 
         void computeSmoothingNormals();
 
+        // Box around the positions of the vertices, in model space
+        bounding_box computeBounds() const;
+
+        /**
+         * Returns the vertex/triangle adjacency of this mesh, it is built on first use.
+         * Resizing the indices is detected automatically,
+         * call invalidateTopology() after changing indices in place.
+         */
+        const MeshTopology &getTopology();
+        void invalidateTopology();
+
         void render();
         void renderInstances(GLsizei count);
     private:
         static SharedMesh quad;
+
+        std::unique_ptr<MeshTopology> topology;
+        unsigned int topologyNrOfIndices = 0, topologyNrOfVertices = 0;
 };
\ No newline at end of file
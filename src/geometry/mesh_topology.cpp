@@ -0,0 +1,51 @@
+#include "mesh_topology.hpp"
+
+// Standard Headers
+#include <algorithm>
+
+// Local Headers
+#include "utils/parallel.h"
+
+MeshTopology::MeshTopology(const unsigned short *indices, unsigned int nrOfIndices, unsigned int nrOfVertices)
+    : triangleOffsets(nrOfVertices + 1, 0), neighborOffsets(nrOfVertices + 1, 0)
+{
+    unsigned int nrOfTriangles = nrOfIndices / 3;
+
+    // Vertex -> triangle: count, prefix sum, fill.
+    for (unsigned int i = 0; i < nrOfTriangles * 3; i++)
+        triangleOffsets[indices[i] + 1]++;
+
+    for (unsigned int v = 0; v < nrOfVertices; v++)
+        triangleOffsets[v + 1] += triangleOffsets[v];
+
+    vertexTriangles.resize(triangleOffsets.back());
+    std::vector<unsigned int> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+
+    for (unsigned int i = 0; i < nrOfTriangles * 3; i++)
+        vertexTriangles[cursor[indices[i]]++] = i / 3;
+
+    // Vertex -> vertex: every triangle around v adds its 2 other corners, duplicates are removed per vertex.
+    std::vector<unsigned int> candidates(2 * vertexTriangles.size());
+    std::vector<unsigned int> nrOfNeighbors(nrOfVertices);
+
+    parallel::forEach(nrOfVertices, [&](unsigned int v) {
+        unsigned int *begin = candidates.data() + 2 * triangleOffsets[v], *end = begin;
+
+        for (unsigned int t = triangleOffsets[v]; t < triangleOffsets[v + 1]; t++)
+        {
+            const unsigned short *tri = indices + 3 * vertexTriangles[t];
+            for (int c = 0; c < 3; c++)
+                if (tri[c] != v) *end++ = tri[c];
+        }
+        std::sort(begin, end);
+        nrOfNeighbors[v] = std::unique(begin, end) - begin;
+    });
+
+    for (unsigned int v = 0; v < nrOfVertices; v++)
+        neighborOffsets[v + 1] = neighborOffsets[v] + nrOfNeighbors[v];
+
+    vertexNeighbors.resize(neighborOffsets.back());
+    parallel::forEach(nrOfVertices, [&](unsigned int v) {
+        std::copy_n(candidates.begin() + 2 * triangleOffsets[v], nrOfNeighbors[v], vertexNeighbors.begin() + neighborOffsets[v]);
+    });
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Standard Headers
+#include <vector>
+
+/**
+ * Vertex to triangle and vertex to vertex adjacency of an indexed triangle mesh,
+ * in compressed sparse row form.
+ *
+ * The triangles around vertex v are vertexTriangles[triangleOffsets[v]] up to vertexTriangles[triangleOffsets[v + 1]].
+ * Triangle t is made of indices[3 * t], indices[3 * t + 1] and indices[3 * t + 2].
+ *
+ * The neighbors of vertex v are vertexNeighbors[neighborOffsets[v]] up to vertexNeighbors[neighborOffsets[v + 1]].
+ * Neighbors are unique and do not include v itself.
+ */
+struct MeshTopology {
+    std::vector<unsigned int> triangleOffsets;
+    std::vector<unsigned int> vertexTriangles;
+
+    std::vector<unsigned int> neighborOffsets;
+    std::vector<unsigned int> vertexNeighbors;
+
+    MeshTopology(const unsigned short *indices, unsigned int nrOfIndices, unsigned int nrOfVertices);
+
+    unsigned int nrOfVertices() const { return triangleOffsets.size() - 1; }
+};
@@ -68,17 +68,19 @@ void Model::load_model(std::string const &path) {
     }
 
     // process ASSIMP's root node recursively
-    processNode(scene->mRootNode, scene);
+    processNode(scene->mRootNode, scene, -1);
+    nodes.update();
 }
 
 // inits the model
 void Model::upload() {}
 
 // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
-void Model::processNode(aiNode *node, const aiScene* scene)
+void Model::processNode(aiNode *node, const aiScene* scene, int parent)
 {
-    // Renderable * node_placeholder = new DummyRenderable();
-    // node_placeholder->set_parent_matrix(aiMatrix4x4ToGlm(&node->mTransformation));
+    // the root also gets the scale of the model, so it ends up in the world matrix of every node
+    glm::mat4 local = aiMatrix4x4ToGlm(&node->mTransformation);
+    unsigned int index = nodes.addNode(parent, parent < 0 ? global_transform * local : local);
 
     // process each mesh located at the current node
     for(unsigned int i = 0; i < node->mNumMeshes; i++)
@@ -88,15 +90,14 @@ void Model::processNode(aiNode *node, const aiScene* scene)
         // Globals::scene->add_renderable(processMesh(scene->mMeshes[node->mMeshes[i]]), this);
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
         meshes.push_back(processMesh(mesh, scene));
+        meshNodes.push_back(index);
     }
 
     // after we've processed all of the meshes (if any) we then recursively process each of the children nodes
     for(unsigned int i = 0; i < node->mNumChildren; i++)
     {
-        processNode(node->mChildren[i], scene);
+        processNode(node->mChildren[i], scene, index);
     }
-
-    // Globals::scene->add_renderable(node_placeholder, parent);
 }
 
 SharedMesh Model::processMesh(aiMesh * mesh, const aiScene* scene) {
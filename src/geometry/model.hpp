@@ -22,6 +22,7 @@
 #include "mesh.hpp"
 // #include "skinned_mesh.hpp"
 #include "graphics/gl_error.hpp"
+#include "graphics/transform_system.hpp"
 
 class Model;
 typedef std::shared_ptr<Model> SharedModel;
@@ -59,6 +60,13 @@ public:
     void upload();
     void render();
 
+    // Transform of meshes[i] relative to the model, global_transform included
+    glm::mat4 get_mesh_transform(unsigned int i) const { return nodes.getWorld(meshNodes[i]); }
+
+    // Changes the transform of an assimp node relative to its parent, applied by update_nodes()
+    void set_node_transform(unsigned int node, const glm::mat4 & local) { nodes.setLocal(node, local); }
+    void update_nodes() { nodes.update(); }
+
     // int current_animation = -1;
     // void set_animation(int num) {
     //     if (num >= (int) animations.size()) {
@@ -74,10 +82,14 @@ private:
     Assimp::Importer importer;
     glm::mat4 m_GlobalInverseTransform;
 
+    // The assimp node tree flattened in depth first order, meshNodes[i] is the node of meshes[i]
+    TransformSystem nodes;
+    std::vector<unsigned int> meshNodes;
+
 
     // Based off of https://frame.42yeah.casa/2019/12/10/model-loading.html
     void load_model(std::string const &path);
-    void processNode(aiNode *node, const aiScene* scene);
+    void processNode(aiNode *node, const aiScene* scene, int parent);
     SharedMesh processMesh(aiMesh *mesh, const aiScene* scene);
     // void material_uniforms(Shader & shader, const aiMaterial material);
     void loadMaterialTextures(SharedMesh mesh, aiMaterial *mat, aiTextureType type, const aiScene * scene, std::string typeName);
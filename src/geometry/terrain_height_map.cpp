@@ -0,0 +1,321 @@
+#include "terrain_height_map.hpp"
+
+// Standard Headers
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+// Local Headers
+#include "utils/math_utils.h"
+
+namespace {
+    const float QUARTER_PI = mu::PI / 4.f, HALF_PI = mu::PI / 2.f;
+
+    /**
+     * Distance along the ray at which it enters the sphere, 0 when the origin is inside.
+     */
+    bool raySphereEntry(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec3 &center, float radius, float &entry)
+    {
+        glm::vec3 toCenter = center - origin;
+        float tca = glm::dot(toCenter, direction);
+        float d2 = glm::dot(toCenter, toCenter) - tca * tca;
+        if (d2 > radius * radius) return false;
+
+        float thc = std::sqrt(radius * radius - d2);
+        if (tca + thc < 0) return false;
+
+        entry = std::max(0.f, tca - thc);
+        return true;
+    }
+
+    // Möller–Trumbore, both sides of the triangle count as a hit.
+    bool rayTriangle(const glm::vec3 &origin, const glm::vec3 &direction,
+        const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, float &distance)
+    {
+        const float EPSILON = 1e-7f;
+
+        glm::vec3 edge1 = b - a, edge2 = c - a;
+        glm::vec3 p = glm::cross(direction, edge2);
+        float det = glm::dot(edge1, p);
+        if (std::abs(det) < EPSILON) return false;
+
+        float invDet = 1.f / det;
+        glm::vec3 s = origin - a;
+        float u = glm::dot(s, p) * invDet;
+        if (u < 0.f || u > 1.f) return false;
+
+        glm::vec3 q = glm::cross(s, edge1);
+        float v = glm::dot(direction, q) * invDet;
+        if (v < 0.f || u + v > 1.f) return false;
+
+        distance = glm::dot(edge2, q) * invDet;
+        return distance >= 0.f;
+    }
+}
+
+TerrainHeightMap::TerrainHeightMap(const Mesh &mesh, int subdivision) : cells(1u << subdivision)
+{
+    const unsigned int pointsPerRow = cells + 1;
+    const unsigned int vertsPerFace = 4 * cells * cells;
+
+    if (mesh.nrOfVertices != 6 * vertsPerFace)
+        throw mesh.name + " is not a flat Cubesphere with subdivision " + std::to_string(subdivision);
+
+    auto positions = mesh.view<glm::vec3>(mesh.attributes.getOffset(VertAttributes::POSITION));
+
+    for (unsigned int f = 0; f < 6; f++)
+    {
+        Face &face = faces[f];
+        face.points.resize(pointsPerRow * pointsPerRow);
+
+        // Every quad of a flat Cubesphere has its own 4 vertices:
+        // v1--v3
+        // | / |
+        // v2--v4
+        for (unsigned int row = 0; row < cells; row++)
+        {
+            for (unsigned int col = 0; col < cells; col++)
+            {
+                unsigned int k = f * vertsPerFace + 4 * (row * cells + col);
+                face.points[row * pointsPerRow + col] = positions[k];
+                face.points[(row + 1) * pointsPerRow + col] = positions[k + 1];
+                face.points[row * pointsPerRow + col + 1] = positions[k + 2];
+                face.points[(row + 1) * pointsPerRow + col + 1] = positions[k + 3];
+            }
+        }
+
+        buildPyramid(face);
+    }
+}
+
+const glm::vec3 & TerrainHeightMap::point(const Face &face, unsigned int row, unsigned int col) const
+{
+    return face.points[row * (cells + 1) + col];
+}
+
+const TerrainHeightMap::Node & TerrainHeightMap::node(const Face &face, unsigned int level, unsigned int row, unsigned int col) const
+{
+    return face.levels[level][row * (cells >> level) + col];
+}
+
+void TerrainHeightMap::buildPyramid(Face &face)
+{
+    face.levels.clear();
+
+    // Grid cells, bounded by their 4 corners.
+    std::vector<Node> leaves(cells * cells);
+    for (unsigned int row = 0; row < cells; row++)
+    {
+        for (unsigned int col = 0; col < cells; col++)
+        {
+            const glm::vec3 corners[4] = {
+                point(face, row, col), point(face, row + 1, col),
+                point(face, row, col + 1), point(face, row + 1, col + 1)
+            };
+
+            Node &leaf = leaves[row * cells + col];
+            leaf.center = (corners[0] + corners[1] + corners[2] + corners[3]) * .25f;
+            leaf.radius = 0;
+            leaf.minRadius = std::numeric_limits<float>::max();
+            leaf.maxRadius = 0;
+
+            for (const glm::vec3 &corner : corners)
+            {
+                float r = glm::length(corner);
+                leaf.minRadius = std::min(leaf.minRadius, r);
+                leaf.maxRadius = std::max(leaf.maxRadius, r);
+                leaf.radius = std::max(leaf.radius, glm::length(corner - leaf.center));
+            }
+        }
+    }
+    face.levels.push_back(std::move(leaves));
+
+    // Every parent encloses the bounding spheres of its 4 children.
+    for (unsigned int size = cells / 2; size >= 1; size /= 2)
+    {
+        const std::vector<Node> &children = face.levels.back();
+        std::vector<Node> parents(size * size);
+
+        for (unsigned int row = 0; row < size; row++)
+        {
+            for (unsigned int col = 0; col < size; col++)
+            {
+                const Node *quad[4] = {
+                    &children[(2 * row) * (2 * size) + 2 * col], &children[(2 * row) * (2 * size) + 2 * col + 1],
+                    &children[(2 * row + 1) * (2 * size) + 2 * col], &children[(2 * row + 1) * (2 * size) + 2 * col + 1]
+                };
+
+                Node &parent = parents[row * size + col];
+                parent.center = (quad[0]->center + quad[1]->center + quad[2]->center + quad[3]->center) * .25f;
+                parent.radius = 0;
+                parent.minRadius = std::numeric_limits<float>::max();
+                parent.maxRadius = 0;
+
+                for (const Node *child : quad)
+                {
+                    parent.minRadius = std::min(parent.minRadius, child->minRadius);
+                    parent.maxRadius = std::max(parent.maxRadius, child->maxRadius);
+                    parent.radius = std::max(parent.radius, glm::length(child->center - parent.center) + child->radius);
+                }
+            }
+        }
+        face.levels.push_back(std::move(parents));
+    }
+}
+
+float TerrainHeightMap::minRadius() const
+{
+    float r = std::numeric_limits<float>::max();
+    for (const Face &face : faces) r = std::min(r, face.levels.back()[0].minRadius);
+    return r;
+}
+
+float TerrainHeightMap::maxRadius() const
+{
+    float r = 0;
+    for (const Face &face : faces) r = std::max(r, face.levels.back()[0].maxRadius);
+    return r;
+}
+
+int TerrainHeightMap::faceCoordinates(const glm::vec3 &d, unsigned int cells, float &row, float &col)
+{
+    // Rotate the direction into the +X face, the inverse of the swizzles in Cubesphere::buildVerticesFlat()
+    glm::vec3 a = glm::abs(d), local;
+    int face;
+
+    if (a.x >= a.y && a.x >= a.z)
+    {
+        face = d.x > 0 ? 0 : 1;
+        local = d.x > 0 ? glm::vec3(d.x, d.y, d.z) : glm::vec3(-d.x, d.y, -d.z);
+    }
+    else if (a.y >= a.z)
+    {
+        face = d.y > 0 ? 2 : 3;
+        local = d.y > 0 ? glm::vec3(d.y, -d.z, -d.x) : glm::vec3(-d.y, d.z, -d.x);
+    }
+    else
+    {
+        face = d.z > 0 ? 4 : 5;
+        local = d.z > 0 ? glm::vec3(d.z, d.y, -d.x) : glm::vec3(-d.z, d.y, d.x);
+    }
+
+    // See Cubesphere::getUnitPositiveX(), rows go from 45 to -45 degrees latitude, columns from -45 to 45 longitude.
+    float latitude = std::atan2(local.y, local.x);
+    float longitude = std::atan2(-local.z, local.x);
+
+    row = std::clamp((QUARTER_PI - latitude) / HALF_PI * cells, 0.f, (float) cells);
+    col = std::clamp((longitude + QUARTER_PI) / HALF_PI * cells, 0.f, (float) cells);
+    return face;
+}
+
+float TerrainHeightMap::radiusAt(const glm::vec3 &direction) const
+{
+    glm::vec3 dir = glm::normalize(direction);
+
+    float row, col;
+    const Face &face = faces[faceCoordinates(dir, cells, row, col)];
+
+    unsigned int cellRow = std::min((unsigned int) row, cells - 1);
+    unsigned int cellCol = std::min((unsigned int) col, cells - 1);
+
+    TerrainHit hit;
+    hit.distance = std::numeric_limits<float>::max();
+    if (raycastCell(face, cellRow, cellCol, glm::vec3(0.f), dir, hit))
+        return hit.distance;
+
+    // The ray slipped past the edge of the cell, interpolate in grid space instead.
+    float du = row - cellRow, dv = col - cellCol;
+    float r1 = glm::length(point(face, cellRow, cellCol)),
+        r2 = glm::length(point(face, cellRow + 1, cellCol)),
+        r3 = glm::length(point(face, cellRow, cellCol + 1)),
+        r4 = glm::length(point(face, cellRow + 1, cellCol + 1));
+
+    if (du + dv <= 1.f)
+        return r1 + du * (r2 - r1) + dv * (r3 - r1);
+    return r4 + (1.f - du) * (r3 - r4) + (1.f - dv) * (r2 - r4);
+}
+
+void TerrainHeightMap::radiusAt(const std::vector<glm::vec3> &directions, std::vector<float> &radii) const
+{
+    radii.resize(directions.size());
+    for (unsigned int i = 0; i < directions.size(); i++)
+        radii[i] = radiusAt(directions[i]);
+}
+
+bool TerrainHeightMap::raycast(const glm::vec3 &origin, const glm::vec3 &direction, TerrainHit &hit, float maxDistance) const
+{
+    glm::vec3 dir = glm::normalize(direction);
+
+    hit.valid = false;
+    hit.distance = maxDistance;
+
+    for (const Face &face : faces)
+        raycastNode(face, face.levels.size() - 1, 0, 0, origin, dir, hit);
+
+    return hit.valid;
+}
+
+bool TerrainHeightMap::raycastNode(const Face &face, unsigned int level, unsigned int row, unsigned int col,
+    const glm::vec3 &origin, const glm::vec3 &direction, TerrainHit &hit) const
+{
+    const Node &n = node(face, level, row, col);
+
+    float entry;
+    if (!raySphereEntry(origin, direction, n.center, n.radius, entry) || entry > hit.distance)
+        return false;
+
+    if (level == 0)
+        return raycastCell(face, row, col, origin, direction, hit);
+
+    // Visit the children front to back, so the nearest hit can prune the ones behind it.
+    struct Child { unsigned int row, col; float entry; };
+    Child children[4];
+    int nrOfChildren = 0;
+
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        Child child = {2 * row + i / 2, 2 * col + i % 2, 0};
+        const Node &c = node(face, level - 1, child.row, child.col);
+        if (!raySphereEntry(origin, direction, c.center, c.radius, child.entry) || child.entry > hit.distance)
+            continue;
+
+        int j = nrOfChildren++;
+        for (; j > 0 && children[j - 1].entry > child.entry; j--)
+            children[j] = children[j - 1];
+        children[j] = child;
+    }
+
+    bool found = false;
+    for (int i = 0; i < nrOfChildren; i++)
+    {
+        if (children[i].entry > hit.distance) break;
+        found |= raycastNode(face, level - 1, children[i].row, children[i].col, origin, direction, hit);
+    }
+    return found;
+}
+
+bool TerrainHeightMap::raycastCell(const Face &face, unsigned int row, unsigned int col,
+    const glm::vec3 &origin, const glm::vec3 &direction, TerrainHit &hit) const
+{
+    const glm::vec3 &v1 = point(face, row, col), &v2 = point(face, row + 1, col),
+        &v3 = point(face, row, col + 1), &v4 = point(face, row + 1, col + 1);
+
+    // Same triangles as Cubesphere::buildVerticesFlat()
+    const glm::vec3 *triangles[2][3] = {{&v1, &v2, &v3}, {&v3, &v2, &v4}};
+
+    bool found = false;
+    for (auto &tri : triangles)
+    {
+        float distance;
+        if (!rayTriangle(origin, direction, *tri[0], *tri[1], *tri[2], distance) || distance > hit.distance)
+            continue;
+
+        hit.valid = found = true;
+        hit.distance = distance;
+        hit.position = origin + direction * distance;
+        hit.normal = glm::normalize(glm::cross(*tri[1] - *tri[0], *tri[2] - *tri[0]));
+        if (glm::dot(hit.normal, hit.position) < 0) hit.normal = -hit.normal;
+    }
+    return found;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+// Standard Headers
+#include <vector>
+#include <glm/glm.hpp>
+
+// Local Headers
+#include "geometry/mesh.hpp"
+
+/**
+ * Result of a terrain query. Position and normal are in the space the query was made in.
+ */
+struct TerrainHit {
+    bool valid = false;
+    float distance = 0;
+    glm::vec3 position = glm::vec3(0.f);
+    glm::vec3 normal = glm::vec3(0.f);
+    glm::vec2 lonLat = glm::vec2(0.f);
+};
+
+struct TerrainRay {
+    glm::vec3 origin;
+    glm::vec3 direction;
+};
+
+/**
+ * Height lookups and raycasts against a flat (unshared) Cubesphere terrain mesh.
+ *
+ * The vertex grid of every cube face is copied out of the mesh, and a min/max radius
+ * pyramid (a quadtree of bounding spheres) is built on top of it.
+ * A raycast walks the quadtree front to back, so only a handful of triangles are tested
+ * instead of the whole mesh.
+ *
+ * All positions are relative to the center of the planet.
+ */
+class TerrainHeightMap {
+    private:
+        struct Node {
+            glm::vec3 center;
+            float radius;
+            float minRadius, maxRadius;
+        };
+
+        struct Face {
+            // (cells + 1)^2 grid points
+            std::vector<glm::vec3> points;
+            // levels[0] are the grid cells, the last level is the root of the face
+            std::vector<std::vector<Node>> levels;
+        };
+
+        unsigned int cells; // cells per row of a face, always a power of 2
+        Face faces[6];
+
+        const glm::vec3 & point(const Face &face, unsigned int row, unsigned int col) const;
+        const Node & node(const Face &face, unsigned int level, unsigned int row, unsigned int col) const;
+
+        void buildPyramid(Face &face);
+
+        bool raycastNode(const Face &face, unsigned int level, unsigned int row, unsigned int col,
+            const glm::vec3 &origin, const glm::vec3 &direction, TerrainHit &hit) const;
+
+        bool raycastCell(const Face &face, unsigned int row, unsigned int col,
+            const glm::vec3 &origin, const glm::vec3 &direction, TerrainHit &hit) const;
+
+        /**
+         * Finds the cube face a direction points to, and the (fractional) grid row and column on that face.
+         */
+        static int faceCoordinates(const glm::vec3 &direction, unsigned int cells, float &row, float &col);
+
+    public:
+        /**
+         * Builds the height map from a mesh generated by Cubesphere(radius, subdivision, false).
+         * The positions of the mesh are allowed to be displaced along their normal.
+         */
+        TerrainHeightMap(const Mesh &mesh, int subdivision);
+
+        float minRadius() const;
+        float maxRadius() const;
+
+        /**
+         * Distance from the center to the surface of the terrain in the given direction.
+         */
+        float radiusAt(const glm::vec3 &direction) const;
+        void radiusAt(const std::vector<glm::vec3> &directions, std::vector<float> &radii) const;
+
+        /**
+         * Finds the nearest intersection of a ray with the terrain that is closer than maxDistance.
+         */
+        bool raycast(const glm::vec3 &origin, const glm::vec3 &direction, TerrainHit &hit, float maxDistance) const;
+};
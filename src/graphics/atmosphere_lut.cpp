@@ -0,0 +1,304 @@
+#include "atmosphere_lut.hpp"
+
+// Standard Headers
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <cstring>
+#include <cstdint>
+
+// Local Headers
+#include "graphics/gl_error.hpp"
+#include "graphics/gl_state.hpp"
+#include "utils/file/file.h"
+#include "utils/parallel.h"
+
+namespace
+{
+    // Bump when the integration changes, so old cache files are not used anymore
+    const uint32_t CACHE_VERSION = 1;
+
+    const unsigned int TRANSMITTANCE_STEPS = 64, SCATTERING_STEPS = 50, SUN_AZIMUTHS = 8;
+
+    // Mie scattering plus absorption
+    const float MIE_EXTINCTION = 1.f / .9f;
+
+    // Texel i of n is at coordinate i / (n - 1), atmosphere.frag samples the tables the same way
+    float unit(unsigned int i, unsigned int n) { return (float) i / (n - 1); }
+
+    // Zenith cosines are stored squared, so there are more texels near the horizon
+    float muFromUnit(float u) { float x = u * 2.f - 1.f; return x * std::abs(x); }
+    float unitFromMu(float mu) { return .5f + .5f * glm::sign(mu) * std::sqrt(std::abs(mu)); }
+
+    // Altitudes are stored as the square root, so there are more texels near the ground
+    float rFromUnit(float u, float rg, float rt) { return rg + u * u * (rt - rg); }
+    float unitFromR(float r, float rg, float rt) { return std::sqrt(glm::clamp((r - rg) / (rt - rg), 0.f, 1.f)); }
+
+    /**
+     * Distance from radius r along zenith cosine mu to the ground, or to the top of the atmosphere when the ray misses the ground.
+     */
+    float rayLength(float r, float mu, float rg, float rt, bool &hitsGround)
+    {
+        float discriminant = r * r * (mu * mu - 1.f) + rg * rg;
+        hitsGround = mu < 0.f && discriminant >= 0.f;
+
+        if (hitsGround) return std::max(0.f, -r * mu - std::sqrt(discriminant));
+        return std::max(0.f, -r * mu + std::sqrt(std::max(0.f, r * r * (mu * mu - 1.f) + rt * rt)));
+    }
+
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t sizes[5];
+    };
+}
+
+SharedAtmosphereLUT AtmosphereLUT::get(float planetRadius, const AtmosphereProfile &profile)
+{
+    static std::map<std::string, std::weak_ptr<AtmosphereLUT>> luts;
+
+    SharedAtmosphereLUT lut(new AtmosphereLUT(planetRadius, profile));
+    std::string path = lut->cachePath();
+
+    // The path is a hash of everything the tables depend on
+    if (SharedAtmosphereLUT existing = luts[path].lock()) return existing;
+
+    if (!lut->load())
+    {
+        std::cout << "Integrating atmosphere tables for " << path << "\n";
+        lut->computeTransmittance();
+        lut->computeScattering();
+        lut->save();
+    }
+    lut->upload();
+
+    luts[path] = lut;
+    return lut;
+}
+
+AtmosphereLUT::AtmosphereLUT(float planetRadius, const AtmosphereProfile &profile)
+    : planetRadius(planetRadius), profile(profile)
+{
+}
+
+AtmosphereLUT::~AtmosphereLUT()
+{
+    if (transmittanceId) glDeleteTextures(1, &transmittanceId);
+    if (scatteringId) glDeleteTextures(1, &scatteringId);
+}
+
+void AtmosphereLUT::bind(GLuint transmittanceUnit, GLuint scatteringUnit) const
+{
+    GLState::bindTexture(transmittanceUnit, GL_TEXTURE_2D, transmittanceId);
+    GLState::bindTexture(scatteringUnit, GL_TEXTURE_3D, scatteringId);
+}
+
+std::string AtmosphereLUT::cachePath() const
+{
+    const float parameters[] = {
+        planetRadius, profile.height,
+        profile.rayleighScattering.r, profile.rayleighScattering.g, profile.rayleighScattering.b, profile.rayleighScaleHeight,
+        profile.mieScattering, profile.mieScaleHeight,
+        (float) TRANSMITTANCE_MU, (float) TRANSMITTANCE_R, (float) SCATTERING_MU_S, (float) SCATTERING_MU, (float) SCATTERING_R,
+        (float) CACHE_VERSION
+    };
+
+    // FNV-1a, mieG and sunIntensity are applied in the shader so they do not change the tables
+    uint64_t hash = 14695981039346656037ull;
+    const unsigned char *bytes = (const unsigned char *) parameters;
+    for (unsigned int i = 0; i < sizeof(parameters); i++)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+
+    std::stringstream path;
+    path << "atmosphere_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".lut";
+    return path.str();
+}
+
+bool AtmosphereLUT::load()
+{
+    std::vector<unsigned char> data;
+    try
+    {
+        data = File::readBinary(cachePath().c_str());
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    transmittance.resize(TRANSMITTANCE_MU * TRANSMITTANCE_R * 3);
+    scattering.resize(SCATTERING_MU_S * SCATTERING_MU * SCATTERING_R * 4);
+
+    size_t transmittanceSize = transmittance.size() * sizeof(float), scatteringSize = scattering.size() * sizeof(float);
+    if (data.size() != sizeof(CacheHeader) + transmittanceSize + scatteringSize) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, &data[0], sizeof(CacheHeader));
+    const uint32_t sizes[5] = {TRANSMITTANCE_MU, TRANSMITTANCE_R, SCATTERING_MU_S, SCATTERING_MU, SCATTERING_R};
+    if (std::memcmp(header.magic, "ATMO", 4) || header.version != CACHE_VERSION || std::memcmp(header.sizes, sizes, sizeof(sizes)))
+        return false;
+
+    std::memcpy(&transmittance[0], &data[sizeof(CacheHeader)], transmittanceSize);
+    std::memcpy(&scattering[0], &data[sizeof(CacheHeader) + transmittanceSize], scatteringSize);
+    return true;
+}
+
+void AtmosphereLUT::save() const
+{
+    CacheHeader header = {{'A', 'T', 'M', 'O'}, CACHE_VERSION, {TRANSMITTANCE_MU, TRANSMITTANCE_R, SCATTERING_MU_S, SCATTERING_MU, SCATTERING_R}};
+
+    size_t transmittanceSize = transmittance.size() * sizeof(float), scatteringSize = scattering.size() * sizeof(float);
+    std::vector<unsigned char> data(sizeof(CacheHeader) + transmittanceSize + scatteringSize);
+
+    std::memcpy(&data[0], &header, sizeof(CacheHeader));
+    std::memcpy(&data[sizeof(CacheHeader)], &transmittance[0], transmittanceSize);
+    std::memcpy(&data[sizeof(CacheHeader) + transmittanceSize], &scattering[0], scatteringSize);
+
+    File::writeBinary(cachePath().c_str(), data);
+}
+
+void AtmosphereLUT::computeTransmittance()
+{
+    const float rg = planetRadius, rt = atmosphereRadius();
+    transmittance.resize(TRANSMITTANCE_MU * TRANSMITTANCE_R * 3);
+
+    // Rows are expensive, so every row can go to its own thread
+    parallel::forEach(TRANSMITTANCE_R, [&](unsigned int y) {
+        float r = rFromUnit(unit(y, TRANSMITTANCE_R), rg, rt);
+
+        for (unsigned int x = 0; x < TRANSMITTANCE_MU; x++)
+        {
+            float mu = muFromUnit(unit(x, TRANSMITTANCE_MU));
+
+            bool hitsGround;
+            float dt = rayLength(r, mu, rg, rt, hitsGround) / TRANSMITTANCE_STEPS;
+
+            glm::vec3 opticalDepth(0.f);
+            for (unsigned int s = 0; s < TRANSMITTANCE_STEPS; s++)
+            {
+                float t = (s + .5f) * dt;
+                float height = std::sqrt(r * r + t * t + 2.f * r * mu * t) - rg;
+
+                opticalDepth += (profile.rayleighScattering * std::exp(-height / profile.rayleighScaleHeight)
+                    + profile.mieScattering * MIE_EXTINCTION * std::exp(-height / profile.mieScaleHeight)) * dt;
+            }
+
+            glm::vec3 result = glm::exp(-opticalDepth);
+            std::memcpy(&transmittance[(y * TRANSMITTANCE_MU + x) * 3], &result, sizeof(glm::vec3));
+        }
+    }, 1);
+}
+
+glm::vec3 AtmosphereLUT::lookupTransmittance(float r, float mu) const
+{
+    float x = unitFromMu(mu) * (TRANSMITTANCE_MU - 1), y = unitFromR(r, planetRadius, atmosphereRadius()) * (TRANSMITTANCE_R - 1);
+
+    unsigned int x0 = std::min((unsigned int) x, TRANSMITTANCE_MU - 2), y0 = std::min((unsigned int) y, TRANSMITTANCE_R - 2);
+    float fx = x - x0, fy = y - y0;
+
+    auto texel = [&](unsigned int tx, unsigned int ty) {
+        const float *t = &transmittance[(ty * TRANSMITTANCE_MU + tx) * 3];
+        return glm::vec3(t[0], t[1], t[2]);
+    };
+    return glm::mix(
+        glm::mix(texel(x0, y0), texel(x0 + 1, y0), fx),
+        glm::mix(texel(x0, y0 + 1), texel(x0 + 1, y0 + 1), fx),
+        fy
+    );
+}
+
+void AtmosphereLUT::computeScattering()
+{
+    const float rg = planetRadius, rt = atmosphereRadius();
+    scattering.resize(SCATTERING_MU_S * SCATTERING_MU * SCATTERING_R * 4);
+
+    float azimuthCos[SUN_AZIMUTHS];
+    for (unsigned int a = 0; a < SUN_AZIMUTHS; a++)
+        azimuthCos[a] = std::cos(2.f * glm::pi<float>() * (a + .5f) / SUN_AZIMUTHS);
+
+    // One row of sun angles per task
+    parallel::forEach(SCATTERING_R * SCATTERING_MU, [&](unsigned int row) {
+        unsigned int z = row / SCATTERING_MU, y = row % SCATTERING_MU;
+
+        float r = rFromUnit(unit(z, SCATTERING_R), rg, rt);
+        float mu = muFromUnit(unit(y, SCATTERING_MU));
+
+        bool hitsGround;
+        float dt = rayLength(r, mu, rg, rt, hitsGround) / SCATTERING_STEPS;
+
+        for (unsigned int x = 0; x < SCATTERING_MU_S; x++)
+        {
+            float muS = unit(x, SCATTERING_MU_S) * 2.f - 1.f;
+
+            glm::vec3 rayleigh(0.f), mie(0.f), opticalDepth(0.f);
+            for (unsigned int s = 0; s < SCATTERING_STEPS; s++)
+            {
+                float t = (s + .5f) * dt;
+                float rSample = std::sqrt(r * r + t * t + 2.f * r * mu * t);
+                float height = rSample - rg;
+
+                float rayleighDensity = std::exp(-height / profile.rayleighScaleHeight);
+                float mieDensity = std::exp(-height / profile.mieScaleHeight);
+
+                // Transmittance from the start of the ray to the middle of this step
+                glm::vec3 step = (profile.rayleighScattering * rayleighDensity + profile.mieScattering * MIE_EXTINCTION * mieDensity) * dt;
+                glm::vec3 viewTransmittance = glm::exp(-(opticalDepth + step * .5f));
+                opticalDepth += step;
+
+                // Light of the sun that reaches the sample, for sun directions around the zenith with the same angle
+                glm::vec3 sunTransmittance(0.f);
+                for (unsigned int a = 0; a < SUN_AZIMUTHS; a++)
+                {
+                    float nu = mu * muS + std::sqrt(std::max(0.f, 1.f - mu * mu)) * std::sqrt(std::max(0.f, 1.f - muS * muS)) * azimuthCos[a];
+                    float muSSample = glm::clamp((r * muS + t * nu) / rSample, -1.f, 1.f);
+
+                    bool inShadow;
+                    rayLength(rSample, muSSample, rg, rt, inShadow);
+                    if (!inShadow) sunTransmittance += lookupTransmittance(rSample, muSSample);
+                }
+                sunTransmittance /= (float) SUN_AZIMUTHS;
+
+                rayleigh += rayleighDensity * viewTransmittance * sunTransmittance * dt;
+                mie += mieDensity * viewTransmittance * sunTransmittance * dt;
+            }
+
+            float *texel = &scattering[((z * SCATTERING_MU + y) * SCATTERING_MU_S + x) * 4];
+            glm::vec3 rayleighScattering = rayleigh * profile.rayleighScattering;
+            texel[0] = rayleighScattering.r;
+            texel[1] = rayleighScattering.g;
+            texel[2] = rayleighScattering.b;
+            texel[3] = mie.r * profile.mieScattering;
+        }
+    }, 1);
+}
+
+void AtmosphereLUT::upload()
+{
+    check_gl_error();
+
+    glGenTextures(1, &transmittanceId);
+    glBindTexture(GL_TEXTURE_2D, transmittanceId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, TRANSMITTANCE_MU, TRANSMITTANCE_R, 0, GL_RGB, GL_FLOAT, &transmittance[0]);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenTextures(1, &scatteringId);
+    glBindTexture(GL_TEXTURE_3D, scatteringId);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA16F, SCATTERING_MU_S, SCATTERING_MU, SCATTERING_R, 0, GL_RGBA, GL_FLOAT, &scattering[0]);
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    check_gl_error();
+
+    // The tables are only needed on the GPU from now on
+    std::vector<float>().swap(transmittance);
+    std::vector<float>().swap(scattering);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+// System Headers
+#include <glad/glad.h>
+
+// Standard Headers
+#include <vector>
+#include <memory>
+#include <string>
+#include <glm/glm.hpp>
+
+/**
+ * Physical description of an atmosphere, in world units.
+ * The defaults are the atmosphere of the earth, scaled to a height of 50.
+ */
+struct AtmosphereProfile {
+    // Distance from the surface to the top of the atmosphere
+    float height = 50.f;
+
+    // Scattering coefficients at the surface, and the height at which the density has dropped to 1 / e
+    glm::vec3 rayleighScattering = glm::vec3(5.8e-6f, 13.5e-6f, 33.1e-6f) * 1200.f;
+    float rayleighScaleHeight = 6.67f;
+
+    float mieScattering = 21e-6f * 1200.f;
+    float mieScaleHeight = 1.f;
+
+    // Asymmetry of the Mie phase function, towards 1 is more forward scattering
+    float mieG = .76f;
+
+    float sunIntensity = 20.f;
+};
+
+class AtmosphereLUT;
+typedef std::shared_ptr<AtmosphereLUT> SharedAtmosphereLUT;
+
+/**
+ * Precomputed transmittance and single scattering of an atmosphere (Bruneton & Neyret, with the
+ * 3D scattering table of Elek), sampled by atmosphere.frag instead of integrating along every pixel.
+ *
+ * transmittance: 2D, (view zenith, altitude) -> transmittance to the end of the ray.
+ * scattering: 3D, (sun zenith, view zenith, altitude) -> light scattered towards the viewer along the ray,
+ * Rayleigh in rgb and the red channel of Mie in alpha. The phase functions are applied per pixel.
+ * The sun azimuth is averaged out, it only changes the sun transmittance at the samples a little.
+ *
+ * The tables depend only on the planet radius and the profile, so planets with the same atmosphere share them.
+ * They are integrated on all CPU cores once and cached on disk, later runs only read the file.
+ */
+class AtmosphereLUT
+{
+  public:
+    // Has to match the sizes in atmosphere.frag
+    static const unsigned int TRANSMITTANCE_MU = 256, TRANSMITTANCE_R = 64;
+    static const unsigned int SCATTERING_MU_S = 32, SCATTERING_MU = 128, SCATTERING_R = 32;
+
+    const float planetRadius;
+    const AtmosphereProfile profile;
+
+    /**
+     * Returns the tables of the atmosphere, computed or loaded from the cache the first time.
+     * Needs a GL context, the tables are uploaded right away.
+     */
+    static SharedAtmosphereLUT get(float planetRadius, const AtmosphereProfile &profile);
+
+    ~AtmosphereLUT();
+
+    float atmosphereRadius() const { return planetRadius + profile.height; }
+
+    void bind(GLuint transmittanceUnit, GLuint scatteringUnit) const;
+
+  private:
+    AtmosphereLUT(float planetRadius, const AtmosphereProfile &profile);
+
+    // rgb per texel, and rgba per texel
+    std::vector<float> transmittance, scattering;
+    GLuint transmittanceId = 0, scatteringId = 0;
+
+    std::string cachePath() const;
+    bool load();
+    void save() const;
+
+    void computeTransmittance();
+    void computeScattering();
+    void upload();
+
+    glm::vec3 lookupTransmittance(float r, float mu) const;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+// Standard Headers
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * Typed, strided view of one attribute in an interleaved vertex array.
+ *
+ * The base pointer and stride are resolved once, so view[i] is a single strided load/store
+ * instead of the memcpy + getVertSize() of VertData::get/set.
+ *
+ * When STRIDE is not 0 the stride is a compile time constant, for loops over a known layout.
+ *
+ * Example:
+ * auto positions = mesh->view<glm::vec3>(posOffset);
+ * for (glm::vec3 &p : positions) p *= 2.f;
+ */
+template <class type, unsigned int STRIDE = 0>
+class AttributeView
+{
+  public:
+    typedef typename std::conditional<std::is_const<type>::value, const unsigned char, unsigned char>::type byte;
+
+    class iterator
+    {
+      public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename std::remove_const<type>::type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef type *pointer;
+        typedef type &reference;
+
+        iterator(byte *ptr, unsigned int stride) : ptr(ptr), stride(stride) {}
+
+        reference operator*() const { return *reinterpret_cast<type *>(ptr); }
+        pointer operator->() const { return reinterpret_cast<type *>(ptr); }
+        reference operator[](difference_type n) const { return *reinterpret_cast<type *>(ptr + n * stride); }
+
+        iterator &operator++() { ptr += stride; return *this; }
+        iterator operator++(int) { iterator it = *this; ptr += stride; return it; }
+        iterator &operator--() { ptr -= stride; return *this; }
+        iterator operator--(int) { iterator it = *this; ptr -= stride; return it; }
+        iterator &operator+=(difference_type n) { ptr += n * stride; return *this; }
+        iterator &operator-=(difference_type n) { ptr -= n * stride; return *this; }
+        iterator operator+(difference_type n) const { return iterator(ptr + n * stride, stride); }
+        iterator operator-(difference_type n) const { return iterator(ptr - n * stride, stride); }
+        difference_type operator-(const iterator &other) const { return (ptr - other.ptr) / (difference_type) stride; }
+
+        bool operator==(const iterator &other) const { return ptr == other.ptr; }
+        bool operator!=(const iterator &other) const { return ptr != other.ptr; }
+        bool operator<(const iterator &other) const { return ptr < other.ptr; }
+
+      private:
+        byte *ptr;
+        unsigned int stride;
+    };
+
+    AttributeView(byte *base, unsigned int stride, unsigned int count)
+        : base(base), runtimeStride(stride), count(count)
+    {}
+
+    inline unsigned int stride() const { return STRIDE ? STRIDE : runtimeStride; }
+    inline unsigned int size() const { return count; }
+
+    inline type &operator[](unsigned int i) const
+    {
+        return *reinterpret_cast<type *>(base + i * stride());
+    }
+
+    iterator begin() const { return iterator(base, stride()); }
+    iterator end() const { return iterator(base + count * stride(), stride()); }
+
+  private:
+    byte *base;
+    unsigned int runtimeStride, count;
+};
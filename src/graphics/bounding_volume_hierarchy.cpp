@@ -0,0 +1,98 @@
+#include "bounding_volume_hierarchy.hpp"
+
+// Standard Headers
+#include <algorithm>
+
+void BoundingVolumeHierarchy::build(const std::vector<bounding_box> &bounds, const std::vector<bool> &bounded)
+{
+    // clear() keeps the capacity, so after the first frame this does not allocate
+    nodes.clear();
+    indices.clear();
+    unbounded.clear();
+    boxes = bounds;
+    centers.resize(bounds.size());
+
+    for (unsigned int i = 0; i < bounds.size(); i++)
+    {
+        if (!bounded[i])
+        {
+            unbounded.push_back(i);
+            continue;
+        }
+        indices.push_back(i);
+        centers[i] = (bounds[i].min + bounds[i].max) * .5f;
+    }
+
+    if (!indices.empty()) buildNode(0, indices.size());
+}
+
+int BoundingVolumeHierarchy::buildNode(unsigned int first, unsigned int count)
+{
+    int index = nodes.size();
+    nodes.emplace_back();
+    nodes[index].first = first;
+    nodes[index].count = count;
+
+    bounding_box box = boxes[indices[first]];
+    glm::vec3 centerMin = centers[indices[first]], centerMax = centerMin;
+    for (unsigned int i = first + 1; i < first + count; i++)
+    {
+        box.min = glm::min(box.min, boxes[indices[i]].min);
+        box.max = glm::max(box.max, boxes[indices[i]].max);
+        centerMin = glm::min(centerMin, centers[indices[i]]);
+        centerMax = glm::max(centerMax, centers[indices[i]]);
+    }
+    nodes[index].bounds = box;
+
+    if (count <= MAX_LEAF_SIZE) return index;
+
+    // Split at the median center along the axis where the centers are spread the most
+    glm::vec3 spread = centerMax - centerMin;
+    int axis = spread.x > spread.y ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+
+    unsigned int half = count / 2;
+    auto begin = indices.begin() + first;
+    std::nth_element(begin, begin + half, begin + count, [&](unsigned int a, unsigned int b) {
+        return centers[a][axis] < centers[b][axis];
+    });
+
+    // nodes can grow while building the children, so no references into it are kept
+    int left = buildNode(first, half);
+    int right = buildNode(first + half, count - half);
+    nodes[index].left = left;
+    nodes[index].right = right;
+    return index;
+}
+
+void BoundingVolumeHierarchy::cull(const Frustum &frustum, std::vector<unsigned int> &visible) const
+{
+    visible.assign(unbounded.begin(), unbounded.end());
+    if (!nodes.empty()) cullNode(0, frustum, visible);
+
+    // Keeps the order of the items, so parents still come before their children
+    std::sort(visible.begin(), visible.end());
+}
+
+void BoundingVolumeHierarchy::cullNode(int index, const Frustum &frustum, std::vector<unsigned int> &visible) const
+{
+    const Node &node = nodes[index];
+
+    Frustum::Result result = frustum.classify(node.bounds);
+    if (result == Frustum::OUTSIDE) return;
+
+    if (result == Frustum::INSIDE)
+    {
+        visible.insert(visible.end(), indices.begin() + node.first, indices.begin() + node.first + node.count);
+        return;
+    }
+
+    if (node.left == -1)
+    {
+        for (unsigned int i = node.first; i < node.first + node.count; i++)
+            if (frustum.intersects(boxes[indices[i]])) visible.push_back(indices[i]);
+        return;
+    }
+
+    cullNode(node.left, frustum, visible);
+    cullNode(node.right, frustum, visible);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// Standard Headers
+#include <vector>
+
+// Local Headers
+#include "utils/obb.hpp"
+#include "graphics/frustum.hpp"
+
+/**
+ * Binary tree of world space boxes, to find the items that are in a view frustum
+ * without testing every item against every pass.
+ *
+ * The items move every frame (planets follow their orbits), so the tree is rebuilt by build()
+ * instead of refitted: with a few hundred items a median split is cheaper than keeping a refitted tree balanced.
+ * Every node covers a contiguous range of the item indices, so a node that is completely
+ * inside the frustum adds its whole range without testing its children.
+ */
+class BoundingVolumeHierarchy
+{
+  public:
+    /**
+     * bounds[i] is the world box of item i, bounded[i] is false for items without a box (they are always visible).
+     */
+    void build(const std::vector<bounding_box> &bounds, const std::vector<bool> &bounded);
+
+    /**
+     * Replaces the contents of visible with the indices of the items that intersect the frustum, in increasing order.
+     */
+    void cull(const Frustum &frustum, std::vector<unsigned int> &visible) const;
+
+  private:
+    // Leaves hold up to this many items
+    static const unsigned int MAX_LEAF_SIZE = 2;
+
+    struct Node {
+        bounding_box bounds;
+
+        // Range in indices covered by this node, children are -1 for leaves
+        unsigned int first, count;
+        int left = -1, right = -1;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<unsigned int> indices, unbounded;
+    std::vector<bounding_box> boxes;
+    std::vector<glm::vec3> centers;
+
+    int buildNode(unsigned int first, unsigned int count);
+
+    void cullNode(int node, const Frustum &frustum, std::vector<unsigned int> &visible) const;
+};
@@ -6,6 +6,8 @@
 
 // Local Headers
 #include "graphics/gl_error.hpp"
+#include "graphics/gl_state.hpp"
+#include "graphics/profiler.hpp"
 
 CubeMap::CubeMap()
     : width(0), height(0),
@@ -19,12 +21,13 @@ CubeMap::CubeMap()
 
 void CubeMap::bind(GLuint unit)
 {
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, id);
+    GLState::bindTexture(unit, GL_TEXTURE_CUBE_MAP, id);
 }
 
 void CubeMap::generate(unsigned int width, unsigned int height, unsigned char * buffers[6])
 {
+    Profiler::CpuScope profile("CubeMap::generate");
+
     this->width = width;
     this->height = height;
 
@@ -6,6 +6,7 @@
 
 // Local Headers
 #include "graphics/window_size.hpp"
+#include "graphics/gl_state.hpp"
 
 void FrameBuffer::unbindCurrent()
 {
@@ -44,7 +45,7 @@ FrameBuffer::~FrameBuffer()
 
 void FrameBuffer::bind()
 {
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::bindTexture(0, GL_TEXTURE_2D, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, id);
     glViewport(0, 0, width, height);
 }
@@ -164,6 +165,25 @@ void FrameBuffer::addDepthBuffer()
     unbindCurrent();
 }
 
+void FrameBuffer::attachColorTexture(SharedTexture texture)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, id);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->id, 0);
+    colorTexture = texture;
+
+    unbindCurrent();
+}
+
+void FrameBuffer::bindDepthLayer(const TextureArray &texture, GLuint layer)
+{
+    bind();
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture.id, 0, layer);
+
+    // Depth only
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+}
+
 void FrameBuffer::bindAndGetPixels(GLenum format, std::vector<GLubyte> &out, unsigned int outOffset)
 {
     GLuint components = -1;
@@ -8,6 +8,7 @@
 
 // Local Headers
 #include "graphics/texture.hpp"
+#include "graphics/texture_array.hpp"
 
 class FrameBuffer
 {
@@ -40,6 +41,12 @@ class FrameBuffer
 
     void addDepthBuffer();
 
+    // Renders into an existing texture, for example the color texture of another FrameBuffer
+    void attachColorTexture(SharedTexture texture);
+
+    // Binds the FrameBuffer with one layer of a depth TextureArray as its only attachment
+    void bindDepthLayer(const TextureArray &texture, GLuint layer);
+
     // function to get the color pixels. Note: it binds the FrameBuffer
     void bindAndGetPixels(GLenum format, std::vector<GLubyte> &out, unsigned int outOffset);
 
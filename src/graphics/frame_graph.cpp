@@ -0,0 +1,182 @@
+#include "frame_graph.hpp"
+
+// Standard Headers
+#include <algorithm>
+
+// Local Headers
+#include "graphics/profiler.hpp"
+
+void FrameGraph::PassBuilder::read(Resource resource)
+{
+    graph.passes[pass].reads.push_back(resource);
+}
+
+void FrameGraph::PassBuilder::write(Resource resource)
+{
+    graph.passes[pass].writes.push_back(resource);
+}
+
+void FrameGraph::PassBuilder::sideEffect()
+{
+    graph.passes[pass].sideEffect = true;
+}
+
+FrameGraph::Resource FrameGraph::createTarget(const std::string &name, const RenderTargetDesc &desc)
+{
+    ResourceNode node;
+    node.name = name;
+    node.transient = true;
+    node.desc = desc;
+    resources.push_back(node);
+    return resources.size() - 1;
+}
+
+FrameGraph::Resource FrameGraph::importTarget(const std::string &name, FrameBuffer * target)
+{
+    ResourceNode node;
+    node.name = name;
+    node.transient = false;
+    node.target = target;
+    resources.push_back(node);
+    return resources.size() - 1;
+}
+
+FrameGraph::Resource FrameGraph::importTextureArray(const std::string &name, SharedTexArray texture)
+{
+    ResourceNode node;
+    node.name = name;
+    node.transient = false;
+    node.textureArray = texture;
+    resources.push_back(node);
+    return resources.size() - 1;
+}
+
+void FrameGraph::markOutput(Resource resource)
+{
+    resources[resource].output = true;
+}
+
+void FrameGraph::addPass(const std::string &name, const std::function<void(PassBuilder &)> &setup, const std::function<void()> &execute)
+{
+    PassNode node;
+    node.name = name;
+    node.execute = execute;
+    passes.push_back(node);
+
+    PassBuilder builder(*this, passes.size() - 1);
+    setup(builder);
+    compiled = false;
+}
+
+void FrameGraph::compile()
+{
+    std::vector<bool> needed(resources.size(), false);
+    for (unsigned int r = 0; r < resources.size(); r++) needed[r] = resources[r].output;
+
+    // Backwards: a pass is kept when a later kept pass (or the frame) needs what it writes
+    for (int p = passes.size() - 1; p >= 0; p--)
+    {
+        PassNode &pass = passes[p];
+
+        bool used = pass.sideEffect;
+        for (Resource r : pass.writes) used |= needed[r];
+
+        pass.culled = !used;
+        if (pass.culled) continue;
+
+        for (Resource r : pass.reads) needed[r] = true;
+    }
+
+    for (ResourceNode &resource : resources) resource.firstUse = resource.lastUse = -1;
+
+    std::vector<bool> written(resources.size(), false);
+    for (unsigned int p = 0; p < passes.size(); p++)
+    {
+        const PassNode &pass = passes[p];
+        if (pass.culled) continue;
+
+        for (Resource r : pass.reads)
+        {
+            ResourceNode &resource = resources[r];
+            if (resource.transient && !written[r])
+                throw "FrameGraph: pass " + pass.name + " reads " + resource.name + " before any pass wrote it";
+
+            resource.lastUse = p;
+        }
+        for (Resource r : pass.writes)
+        {
+            ResourceNode &resource = resources[r];
+            if (resource.firstUse < 0) resource.firstUse = p;
+            resource.lastUse = std::max(resource.lastUse, (int) p);
+            written[r] = true;
+        }
+    }
+    compiled = true;
+}
+
+void FrameGraph::execute(RenderTargetPool &pool)
+{
+    if (!compiled) compile();
+    executed.clear();
+
+    for (unsigned int p = 0; p < passes.size(); p++)
+    {
+        const PassNode &pass = passes[p];
+        if (pass.culled) continue;
+
+        for (ResourceNode &resource : resources)
+            if (resource.transient && resource.firstUse == (int) p) resource.target = pool.acquire(resource.desc);
+
+        running = p;
+        {
+            Profiler::CpuScope cpuTime(pass.name);
+            Profiler::GpuScope gpuTime(pass.name);
+            pass.execute();
+        }
+        running = -1;
+        executed.push_back(pass.name);
+
+        for (ResourceNode &resource : resources)
+        {
+            if (!resource.transient || resource.lastUse != (int) p) continue;
+
+            pool.release(resource.target);
+            resource.target = NULL;
+        }
+    }
+}
+
+void FrameGraph::reset()
+{
+    resources.clear();
+    passes.clear();
+    compiled = false;
+}
+
+const FrameGraph::ResourceNode & FrameGraph::access(const std::string &name) const
+{
+    if (running < 0) throw "FrameGraph: " + name + " was used outside of a pass";
+
+    const PassNode &pass = passes[running];
+    for (unsigned int r = 0; r < resources.size(); r++)
+    {
+        if (resources[r].name != name) continue;
+
+        bool declared = std::find(pass.reads.begin(), pass.reads.end(), r) != pass.reads.end()
+            || std::find(pass.writes.begin(), pass.writes.end(), r) != pass.writes.end();
+        if (!declared) throw "FrameGraph: pass " + pass.name + " uses " + name + " without declaring it";
+
+        return resources[r];
+    }
+    throw "FrameGraph: there is no resource named " + name;
+}
+
+FrameBuffer * FrameGraph::getTarget(const std::string &name) const
+{
+    return access(name).target;
+}
+
+SharedTexArray FrameGraph::getTextureArray(const std::string &name) const
+{
+    return access(name).textureArray;
+}
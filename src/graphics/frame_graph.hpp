@@ -0,0 +1,120 @@
+#pragma once
+
+// Standard Headers
+#include <functional>
+#include <string>
+#include <vector>
+
+// Local Headers
+#include "graphics/frame_buffer.hpp"
+#include "graphics/render_target_pool.hpp"
+#include "graphics/texture_array.hpp"
+
+/**
+ * The passes of a frame and the targets they read and write.
+ *
+ * Every frame the Scene declares its passes with addPass(). The setup function of a pass declares
+ * what it reads and writes, the execute function draws. compile() then:
+ *  - culls the passes whose writes are not read by a pass that is kept, or are not an output of the frame
+ *    (the screen). Passes marked with sideEffect() are always kept.
+ *  - finds the first and last pass that uses every transient target, execute() acquires the target
+ *    from the RenderTargetPool right before the first one and releases it after the last one,
+ *    so targets with lifetimes that do not overlap share memory.
+ *
+ * Passes run in the order they were added, a pass can only depend on passes that were added before it.
+ * A pass finds its inputs with getTarget() and getTextureArray(), which throw when the running pass
+ * did not declare the resource. A pass can not use the result of another pass by accident that way.
+ *
+ * execute() times every pass with the Profiler, on the CPU and on the GPU, so passes can not contain GPU scopes themselves.
+ */
+class FrameGraph
+{
+  public:
+    typedef unsigned int Resource;
+
+    class PassBuilder
+    {
+      public:
+        void read(Resource resource);
+        void write(Resource resource);
+
+        // Never culled, for passes whose results are not in a resource
+        void sideEffect();
+
+      private:
+        friend class FrameGraph;
+        PassBuilder(FrameGraph &graph, unsigned int pass): graph(graph), pass(pass) {}
+
+        FrameGraph &graph;
+        unsigned int pass;
+    };
+
+    /**
+     * A target that only lives during this frame, allocated from the pool when its first pass runs.
+     */
+    Resource createTarget(const std::string &name, const RenderTargetDesc &desc);
+
+    /**
+     * A target that lives outside the graph, for results that are kept over multiple frames.
+     * NULL is the default FrameBuffer (the screen).
+     */
+    Resource importTarget(const std::string &name, FrameBuffer * target);
+
+    Resource importTextureArray(const std::string &name, SharedTexArray texture);
+
+    /**
+     * Resources that leave the frame, the passes that lead up to them are kept.
+     */
+    void markOutput(Resource resource);
+
+    void addPass(const std::string &name, const std::function<void(PassBuilder &)> &setup, const std::function<void()> &execute);
+
+    void compile();
+
+    void execute(RenderTargetPool &pool);
+
+    /**
+     * Removes all passes and resources, for the declarations of the next frame.
+     */
+    void reset();
+
+    /**
+     * Only for the running pass, and only for resources it declared.
+     */
+    FrameBuffer * getTarget(const std::string &name) const;
+    SharedTexArray getTextureArray(const std::string &name) const;
+
+    /**
+     * Names of the passes that ran in the last execute(), in order.
+     */
+    const std::vector<std::string> & getExecutedPasses() const { return executed; }
+
+  private:
+    struct ResourceNode {
+        std::string name;
+        bool transient, output = false;
+        RenderTargetDesc desc;
+        FrameBuffer * target = NULL;
+        SharedTexArray textureArray;
+
+        // Passes that use the resource first and last, -1 when no kept pass uses it
+        int firstUse = -1, lastUse = -1;
+    };
+
+    struct PassNode {
+        std::string name;
+        std::function<void()> execute;
+        std::vector<Resource> reads, writes;
+        bool sideEffect = false, culled = false;
+    };
+
+    std::vector<ResourceNode> resources;
+    std::vector<PassNode> passes;
+    std::vector<std::string> executed;
+
+    // Index of the pass in execute(), -1 outside of execute()
+    int running = -1;
+    bool compiled = false;
+
+    const ResourceNode & access(const std::string &name) const;
+};
@@ -0,0 +1,99 @@
+#include "frustum.hpp"
+
+// Standard Headers
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+Frustum::Frustum(const glm::mat4 &m)
+{
+    // Rows of the (column major) matrix
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; i++) row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+    // left, right, bottom, top, near, far
+    const glm::vec4 planes[6] = {
+        row[3] + row[0], row[3] - row[0],
+        row[3] + row[1], row[3] - row[1],
+        row[3] + row[2], row[3] - row[2]
+    };
+
+    for (int i = 0; i < NR_OF_PLANES; i++)
+    {
+        // The padding planes have no normal and are always passed
+        glm::vec4 plane = i < 6 ? planes[i] / glm::length(glm::vec3(planes[i])) : glm::vec4(0.f, 0.f, 0.f, 1.f);
+
+        nx[i] = plane.x;
+        ny[i] = plane.y;
+        nz[i] = plane.z;
+        d[i] = plane.w;
+        absNx[i] = std::abs(plane.x);
+        absNy[i] = std::abs(plane.y);
+        absNz[i] = std::abs(plane.z);
+    }
+}
+
+bool Frustum::intersects(const glm::vec3 &center, float radius) const
+{
+    #ifdef FRUSTUM_SSE
+    const __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+    const __m128 negRadius = _mm_set1_ps(-radius);
+
+    for (int i = 0; i < NR_OF_PLANES; i += 4)
+    {
+        __m128 distance = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_load_ps(nx + i), cx), _mm_mul_ps(_mm_load_ps(ny + i), cy)),
+            _mm_add_ps(_mm_mul_ps(_mm_load_ps(nz + i), cz), _mm_load_ps(d + i)));
+
+        if (_mm_movemask_ps(_mm_cmplt_ps(distance, negRadius))) return false;
+    }
+    return true;
+    #else
+    for (int i = 0; i < 6; i++)
+        if (nx[i] * center.x + ny[i] * center.y + nz[i] * center.z + d[i] < -radius) return false;
+    return true;
+    #endif
+}
+
+Frustum::Result Frustum::classify(const bounding_box &box) const
+{
+    glm::vec3 center = (box.min + box.max) * .5f, extent = (box.max - box.min) * .5f;
+
+    #ifdef FRUSTUM_SSE
+    const __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+    const __m128 ex = _mm_set1_ps(extent.x), ey = _mm_set1_ps(extent.y), ez = _mm_set1_ps(extent.z);
+    const __m128 zero = _mm_setzero_ps();
+
+    int outside = 0, intersecting = 0;
+    for (int i = 0; i < NR_OF_PLANES; i += 4)
+    {
+        __m128 distance = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_load_ps(nx + i), cx), _mm_mul_ps(_mm_load_ps(ny + i), cy)),
+            _mm_add_ps(_mm_mul_ps(_mm_load_ps(nz + i), cz), _mm_load_ps(d + i)));
+
+        // Half the size of the box along the normal
+        __m128 radius = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_load_ps(absNx + i), ex), _mm_mul_ps(_mm_load_ps(absNy + i), ey)),
+            _mm_mul_ps(_mm_load_ps(absNz + i), ez));
+
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+        intersecting |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(distance, radius), zero));
+    }
+    #else
+    bool outside = false, intersecting = false;
+    for (int i = 0; i < 6; i++)
+    {
+        float distance = nx[i] * center.x + ny[i] * center.y + nz[i] * center.z + d[i];
+        float radius = absNx[i] * extent.x + absNy[i] * extent.y + absNz[i] * extent.z;
+
+        outside |= distance + radius < 0;
+        intersecting |= distance - radius < 0;
+    }
+    #endif
+
+    if (outside) return OUTSIDE;
+    return intersecting ? INTERSECTING : INSIDE;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Standard Headers
+#include <glm/glm.hpp>
+
+// Local Headers
+#include "utils/obb.hpp"
+
+/**
+ * The 6 planes of a view frustum in world space, extracted from a view projection matrix (Gribb & Hartmann).
+ *
+ * The planes are stored as a structure of arrays and padded to 8, so a test is 2 iterations
+ * of 4 planes at once with SSE. Without SSE the same tests run plane by plane.
+ */
+class Frustum
+{
+  public:
+    enum Result { OUTSIDE, INTERSECTING, INSIDE };
+
+    /**
+     * viewProjection: Camera::combined, works for perspective and orthographic cameras.
+     */
+    Frustum(const glm::mat4 &viewProjection);
+
+    bool intersects(const glm::vec3 &center, float radius) const;
+
+    bool intersects(const bounding_box &box) const { return classify(box) != OUTSIDE; }
+
+    /**
+     * INSIDE when the box is inside all planes, so everything in it is visible without more tests.
+     */
+    Result classify(const bounding_box &box) const;
+
+  private:
+    static const int NR_OF_PLANES = 8;
+
+    // Plane i: dot((nx[i], ny[i], nz[i]), p) + d[i] >= 0 for points on the inside
+    // The absolute normals are used for the projected extent of a box.
+    alignas(16) float nx[NR_OF_PLANES], ny[NR_OF_PLANES], nz[NR_OF_PLANES], d[NR_OF_PLANES];
+    alignas(16) float absNx[NR_OF_PLANES], absNy[NR_OF_PLANES], absNz[NR_OF_PLANES];
+};
@@ -0,0 +1,768 @@
+#include "gl_recorder.hpp"
+
+// System Headers
+#include <glad/glad.h>
+
+// Standard Headers
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+// Local Headers
+#include "graphics/gl_state.hpp"
+
+// Every GL function that is called in the tree, without the gl prefix
+#define GL_RECORDED_FUNCTIONS(X) \
+    X(ActiveTexture) X(AttachShader) X(BeginQuery) X(BindBuffer) X(BindBufferRange) X(BindFramebuffer) \
+    X(BindRenderbuffer) X(BindSampler) X(BindTexture) X(BindVertexArray) X(BlendEquation) X(BlendEquationSeparate) \
+    X(BlendFunc) X(BlendFuncSeparate) X(BlitFramebuffer) X(BufferData) X(BufferSubData) X(Clear) X(ClearColor) \
+    X(ClientWaitSync) X(CompileShader) X(CompressedTexImage2D) X(CompressedTexImage3D) X(CompressedTexSubImage3D) \
+    X(CreateProgram) X(CreateShader) X(CullFace) X(DeleteBuffers) X(DeleteFramebuffers) X(DeleteProgram) \
+    X(DeleteShader) X(DeleteSync) X(DeleteTextures) X(DeleteVertexArrays) X(DepthFunc) X(DepthMask) X(DetachShader) \
+    X(Disable) X(DisableVertexAttribArray) X(DrawArrays) X(DrawBuffer) X(DrawElements) X(DrawElementsBaseVertex) \
+    X(DrawElementsInstanced) X(DrawElementsInstancedBaseVertex) X(Enable) X(EnableVertexAttribArray) X(EndQuery) \
+    X(FenceSync) X(Finish) X(FramebufferRenderbuffer) X(FramebufferTexture2D) X(FramebufferTextureLayer) \
+    X(GenBuffers) X(GenFramebuffers) X(GenQueries) X(GenRenderbuffers) X(GenTextures) X(GenVertexArrays) \
+    X(GenerateMipmap) X(GetActiveUniform) X(GetAttribLocation) X(GetError) X(GetIntegerv) X(GetProgramInfoLog) \
+    X(GetProgramiv) X(GetQueryObjectiv) X(GetQueryObjectui64v) X(GetShaderInfoLog) X(GetShaderiv) X(GetString) \
+    X(GetUniformBlockIndex) X(GetUniformLocation) X(IsEnabled) X(LinkProgram) X(MapBufferRange) X(PixelStorei) \
+    X(PolygonMode) X(PolygonOffset) X(ReadBuffer) X(ReadPixels) X(RenderbufferStorage) \
+    X(RenderbufferStorageMultisample) X(Scissor) X(ShaderSource) X(TexImage2D) X(TexImage3D) X(TexParameteri) \
+    X(Uniform1f) X(Uniform1i) X(Uniform2f) X(Uniform3f) X(Uniform3fv) X(Uniform4f) X(Uniform4i) \
+    X(UniformBlockBinding) X(UniformMatrix4fv) X(UnmapBuffer) X(UseProgram) X(ValidateProgram) \
+    X(VertexAttribDivisor) X(VertexAttribIPointer) X(VertexAttribPointer) X(Viewport) \
+    GL_RECORDED_FUNCTIONS_4_3(X) GL_RECORDED_FUNCTIONS_4_4(X) GL_RECORDED_FUNCTIONS_4_5(X)
+
+// Only loaded by glad when it was generated for these versions, the renderers check the same defines
+#ifdef GL_VERSION_4_3
+#define GL_RECORDED_FUNCTIONS_4_3(X) X(MultiDrawElementsIndirect)
+#else
+#define GL_RECORDED_FUNCTIONS_4_3(X)
+#endif
+
+#ifdef GL_VERSION_4_4
+#define GL_RECORDED_FUNCTIONS_4_4(X) X(BufferStorage)
+#else
+#define GL_RECORDED_FUNCTIONS_4_4(X)
+#endif
+
+#ifdef GL_VERSION_4_5
+#define GL_RECORDED_FUNCTIONS_4_5(X) X(ClipControl)
+#else
+#define GL_RECORDED_FUNCTIONS_4_5(X)
+#endif
+
+namespace GLRecorder
+{
+    namespace
+    {
+        enum Function {
+            #define X(name) F_##name,
+            GL_RECORDED_FUNCTIONS(X)
+            #undef X
+            NR_OF_FUNCTIONS
+        };
+
+        const char *names[] = {
+            #define X(name) "gl" #name,
+            GL_RECORDED_FUNCTIONS(X)
+            #undef X
+        };
+
+        // The glad pointers from before install()
+        struct Pointers {
+            #define X(name) decltype(glad_gl##name) name;
+            GL_RECORDED_FUNCTIONS(X)
+            #undef X
+        } saved;
+
+        // The glad flags that select the GL 4 paths of the renderers
+        int * const flags[] = {
+            #ifdef GL_VERSION_4_3
+            &GLAD_GL_VERSION_4_3, &GLAD_GL_ARB_shader_draw_parameters,
+            #endif
+            #ifdef GL_VERSION_4_4
+            &GLAD_GL_VERSION_4_4, &GLAD_GL_ARB_buffer_storage,
+            #endif
+            NULL
+        };
+        int savedFlags[sizeof(flags) / sizeof(flags[0])];
+
+        bool installed = false, capture = false;
+
+        Stats current, last;
+        std::vector<Call> calls, lastCalls;
+
+        // Pipeline state by key(), the values of the arguments that set it
+        typedef std::array<std::uint64_t, 4> Value;
+        std::unordered_map<std::uint64_t, Value> state;
+
+        // Uniform values by program and location
+        std::unordered_map<std::uint64_t, std::vector<unsigned char>> uniformValues;
+
+        GLuint nextName = 0, program = 0, activeUnit = GL_TEXTURE0;
+        GLint viewport[4] = {0, 0, 0, 0};
+
+        struct Program {
+            // As glGetActiveUniform reports them, arrays end with [0]
+            std::vector<std::string> uniforms, blocks, attributes;
+        };
+        std::unordered_map<GLuint, std::string> sources;
+        std::unordered_map<GLuint, std::vector<GLuint>> attached;
+        std::unordered_map<GLuint, Program> programs;
+
+        // Memory handed out by glMapBufferRange, until uninstall()
+        std::list<std::vector<unsigned char>> mappedRanges;
+
+        template <typename T>
+        std::uint64_t bits(T value)
+        {
+            std::uint64_t b = 0;
+            std::memcpy(&b, &value, sizeof(T));
+            return b;
+        }
+
+        std::uint64_t key(Function group, std::uint64_t selector)
+        {
+            return (std::uint64_t) group << 48 | selector;
+        }
+
+        void record(Function f)
+        {
+            current.calls++;
+            current.perFunction[f]++;
+            if (capture) calls.push_back({(unsigned int) f, false});
+        }
+
+        void markRedundant(Function f)
+        {
+            current.redundantPerFunction[f]++;
+            if (capture) calls.back().redundant = true;
+        }
+
+        bool isSet(std::uint64_t stateKey, const Value &value)
+        {
+            auto it = state.find(stateKey);
+            return it != state.end() && it->second == value;
+        }
+
+        void countState(Function f, bool redundant)
+        {
+            record(f);
+            current.stateChanges++;
+            if (!redundant) return;
+
+            current.redundantStateChanges++;
+            markRedundant(f);
+        }
+
+        // Returns true when the value changed
+        bool changeState(Function f, std::uint64_t stateKey, const Value &value)
+        {
+            bool redundant = isSet(stateKey, value);
+            countState(f, redundant);
+            state[stateKey] = value;
+            return !redundant;
+        }
+
+        void changeUniform(Function f, GLint location, const void *data, size_t size)
+        {
+            record(f);
+            current.uniforms++;
+
+            if (location != -1)
+            {
+                const unsigned char *bytes = (const unsigned char *) data;
+                std::vector<unsigned char> &stored = uniformValues[(std::uint64_t) program << 32 | (GLuint) location];
+                if (stored.size() != size || !std::equal(bytes, bytes + size, stored.begin()))
+                {
+                    stored.assign(bytes, bytes + size);
+                    return;
+                }
+            }
+
+            // Either the value is already set, or GL ignores it
+            current.redundantUniforms++;
+            markRedundant(f);
+        }
+
+        void upload(Function f, GLsizeiptr bytes)
+        {
+            record(f);
+            current.uploads++;
+            current.uploadedBytes += bytes;
+        }
+
+        // Only counts the call, functions with a result return 0
+        template <Function f, typename P> struct Ignore;
+        template <Function f, typename R, typename... A> struct Ignore<f, R (APIENTRYP)(A...)>
+        {
+            static R APIENTRY call(A...) { record(f); return R(); }
+        };
+
+        // State that only depends on the function, like glDepthFunc
+        template <Function f, typename P> struct Setter;
+        template <Function f, typename... A> struct Setter<f, void (APIENTRYP)(A...)>
+        {
+            static void APIENTRY call(A... args) { changeState(f, key(f, 0), Value{{bits(args)...}}); }
+        };
+
+        // State selected by the first argument, like glBindBuffer
+        template <Function f, typename P> struct KeyedSetter;
+        template <Function f, typename K, typename... A> struct KeyedSetter<f, void (APIENTRYP)(K, A...)>
+        {
+            static void APIENTRY call(K selector, A... args) { changeState(f, key(f, bits(selector)), Value{{bits(args)...}}); }
+        };
+
+        template <Function f, typename P> struct Draw;
+        template <Function f, typename... A> struct Draw<f, void (APIENTRYP)(A...)>
+        {
+            static void APIENTRY call(A...) { record(f); current.draws++; }
+        };
+
+        // glUniform with the values as arguments
+        template <Function f, typename P> struct Uniform;
+        template <Function f, typename... A> struct Uniform<f, void (APIENTRYP)(GLint, A...)>
+        {
+            static void APIENTRY call(GLint location, A... values)
+            {
+                const Value value{{bits(values)...}};
+                changeUniform(f, location, value.data(), sizeof...(A) * sizeof(std::uint64_t));
+            }
+        };
+
+        template <Function f>
+        void APIENTRY genNames(GLsizei n, GLuint *ids)
+        {
+            record(f);
+            for (GLsizei i = 0; i < n; i++) ids[i] = ++nextName;
+        }
+
+        GLuint APIENTRY createProgram()
+        {
+            record(F_CreateProgram);
+            return ++nextName;
+        }
+
+        GLuint APIENTRY createShader(GLenum)
+        {
+            record(F_CreateShader);
+            return ++nextName;
+        }
+
+        void APIENTRY shaderSource(GLuint shader, GLsizei count, const GLchar *const *strings, const GLint *lengths)
+        {
+            record(F_ShaderSource);
+
+            std::string &source = sources[shader];
+            source.clear();
+            for (GLsizei i = 0; i < count; i++)
+                source.append(strings[i], lengths && lengths[i] >= 0 ? (size_t) lengths[i] : std::strlen(strings[i]));
+        }
+
+        void APIENTRY attachShader(GLuint program, GLuint shader)
+        {
+            record(F_AttachShader);
+            attached[program].push_back(shader);
+        }
+
+        void APIENTRY detachShader(GLuint program, GLuint shader)
+        {
+            record(F_DetachShader);
+            std::vector<GLuint> &shaders = attached[program];
+            shaders.erase(std::remove(shaders.begin(), shaders.end(), shader), shaders.end());
+        }
+
+        /**
+         * Finds the uniforms the way a driver would report them, except that unused ones are not optimized away.
+         */
+        void APIENTRY linkProgram(GLuint id)
+        {
+            record(F_LinkProgram);
+
+            static const std::regex comment("//[^\\n]*"),
+                                    declaration("\\buniform\\s+\\w+\\s+([^;{]+);"),
+                                    block("\\buniform\\s+(\\w+)\\s*\\{");
+
+            Program linked;
+            for (GLuint shader : attached[id])
+            {
+                std::string source = std::regex_replace(sources[shader], comment, "");
+
+                for (std::sregex_iterator it(source.begin(), source.end(), declaration), end; it != end; ++it)
+                {
+                    // "uniform vec3 up, right;" declares two, "uniform vec3 points[30];" is an array
+                    std::stringstream list((*it)[1].str());
+                    std::string name;
+                    while (std::getline(list, name, ','))
+                    {
+                        name.erase(std::remove_if(name.begin(), name.end(), [](char c) { return std::isspace((unsigned char) c); }), name.end());
+
+                        size_t bracket = name.find('[');
+                        if (bracket != std::string::npos) name = name.substr(0, bracket) + "[0]";
+
+                        if (std::find(linked.uniforms.begin(), linked.uniforms.end(), name) == linked.uniforms.end())
+                            linked.uniforms.push_back(name);
+                    }
+                }
+
+                for (std::sregex_iterator it(source.begin(), source.end(), block), end; it != end; ++it)
+                    if (std::find(linked.blocks.begin(), linked.blocks.end(), (*it)[1].str()) == linked.blocks.end())
+                        linked.blocks.push_back((*it)[1].str());
+            }
+            programs[id] = linked;
+        }
+
+        void APIENTRY getProgramiv(GLuint id, GLenum pname, GLint *params)
+        {
+            record(F_GetProgramiv);
+
+            const Program &linked = programs[id];
+            switch (pname)
+            {
+                case GL_LINK_STATUS: case GL_VALIDATE_STATUS: *params = GL_TRUE; break;
+                case GL_ACTIVE_UNIFORMS: *params = linked.uniforms.size(); break;
+                case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+                    *params = 0;
+                    for (const std::string &name : linked.uniforms) *params = std::max(*params, (GLint) name.size() + 1);
+                    break;
+                default: *params = 0;
+            }
+        }
+
+        void APIENTRY getShaderiv(GLuint, GLenum pname, GLint *params)
+        {
+            record(F_GetShaderiv);
+            *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+        }
+
+        template <Function f>
+        void APIENTRY getInfoLog(GLuint, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+        {
+            record(f);
+            if (length) *length = 0;
+            if (bufSize > 0) infoLog[0] = '\0';
+        }
+
+        void APIENTRY getActiveUniform(GLuint id, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name)
+        {
+            record(F_GetActiveUniform);
+
+            const std::string &uniform = programs[id].uniforms.at(index);
+            GLsizei copied = bufSize > 0 ? std::min((GLsizei) uniform.size(), bufSize - 1) : 0;
+            if (bufSize > 0)
+            {
+                std::memcpy(name, uniform.data(), copied);
+                name[copied] = '\0';
+            }
+            if (length) *length = copied;
+            *size = 1;
+            *type = GL_FLOAT;
+        }
+
+        GLint APIENTRY getUniformLocation(GLuint id, const GLchar *name)
+        {
+            record(F_GetUniformLocation);
+
+            const std::vector<std::string> &uniforms = programs[id].uniforms;
+            for (size_t i = 0; i < uniforms.size(); i++)
+                if (uniforms[i] == name || uniforms[i] == std::string(name) + "[0]") return i;
+            return -1;
+        }
+
+        GLuint APIENTRY getUniformBlockIndex(GLuint id, const GLchar *name)
+        {
+            record(F_GetUniformBlockIndex);
+
+            const std::vector<std::string> &blocks = programs[id].blocks;
+            auto it = std::find(blocks.begin(), blocks.end(), name);
+            return it == blocks.end() ? GL_INVALID_INDEX : it - blocks.begin();
+        }
+
+        GLint APIENTRY getAttribLocation(GLuint id, const GLchar *name)
+        {
+            record(F_GetAttribLocation);
+
+            std::vector<std::string> &attributes = programs[id].attributes;
+            auto it = std::find(attributes.begin(), attributes.end(), name);
+            if (it != attributes.end()) return it - attributes.begin();
+
+            attributes.push_back(name);
+            return attributes.size() - 1;
+        }
+
+        void APIENTRY getIntegerv(GLenum pname, GLint *data)
+        {
+            record(F_GetIntegerv);
+
+            switch (pname)
+            {
+                case GL_VIEWPORT: std::copy(viewport, viewport + 4, data); break;
+                case GL_SCISSOR_BOX: std::fill(data, data + 4, 0); break;
+                case GL_POLYGON_MODE: data[0] = data[1] = GL_FILL; break;
+                case GL_MAJOR_VERSION: case GL_MINOR_VERSION: *data = 3; break;
+                case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT: *data = 256; break;
+                default: *data = 0;
+            }
+        }
+
+        const GLubyte * APIENTRY getString(GLenum name)
+        {
+            record(F_GetString);
+            return (const GLubyte *) (name == GL_VERSION ? "3.3 GLRecorder" : name == GL_SHADING_LANGUAGE_VERSION ? "3.30" : "GLRecorder");
+        }
+
+        // Every query has a result of 0 right away
+        void APIENTRY getQueryObjectiv(GLuint, GLenum pname, GLint *params)
+        {
+            record(F_GetQueryObjectiv);
+            *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+        }
+
+        void APIENTRY getQueryObjectui64v(GLuint, GLenum, GLuint64 *params)
+        {
+            record(F_GetQueryObjectui64v);
+            *params = 0;
+        }
+
+        GLboolean APIENTRY isEnabled(GLenum capability)
+        {
+            record(F_IsEnabled);
+            return isSet(key(F_Enable, capability), Value{{1}});
+        }
+
+        void APIENTRY enable(GLenum capability)
+        {
+            changeState(F_Enable, key(F_Enable, capability), Value{{1}});
+        }
+
+        void APIENTRY disable(GLenum capability)
+        {
+            changeState(F_Disable, key(F_Enable, capability), Value{{0}});
+        }
+
+        void APIENTRY useProgram(GLuint id)
+        {
+            changeState(F_UseProgram, key(F_UseProgram, 0), Value{{id}});
+            program = id;
+        }
+
+        void APIENTRY activeTexture(GLenum unit)
+        {
+            changeState(F_ActiveTexture, key(F_ActiveTexture, 0), Value{{unit}});
+            activeUnit = unit;
+        }
+
+        void APIENTRY bindTexture(GLenum target, GLuint id)
+        {
+            changeState(F_BindTexture, key(F_BindTexture, (std::uint64_t) activeUnit << 32 | target), Value{{id}});
+        }
+
+        void APIENTRY bindVertexArray(GLuint vao)
+        {
+            // The element buffer binding belongs to the vertex array
+            if (changeState(F_BindVertexArray, key(F_BindVertexArray, 0), Value{{vao}}))
+                state.erase(key(F_BindBuffer, GL_ELEMENT_ARRAY_BUFFER));
+        }
+
+        void APIENTRY bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+        {
+            changeState(F_BindBufferRange, key(F_BindBufferRange, (std::uint64_t) target << 32 | index), Value{{buffer, bits(offset), bits(size)}});
+
+            // Binds the generic binding point too
+            state[key(F_BindBuffer, target)] = Value{{buffer}};
+        }
+
+        void APIENTRY bindFramebuffer(GLenum target, GLuint framebuffer)
+        {
+            const Value value{{framebuffer}};
+            if (target != GL_FRAMEBUFFER)
+            {
+                changeState(F_BindFramebuffer, key(F_BindFramebuffer, target), value);
+                return;
+            }
+
+            // Binds both the draw and the read FrameBuffer
+            std::uint64_t draw = key(F_BindFramebuffer, GL_DRAW_FRAMEBUFFER), read = key(F_BindFramebuffer, GL_READ_FRAMEBUFFER);
+            countState(F_BindFramebuffer, isSet(draw, value) && isSet(read, value));
+            state[draw] = state[read] = value;
+        }
+
+        void APIENTRY blendFunc(GLenum src, GLenum dst)
+        {
+            changeState(F_BlendFunc, key(F_BlendFuncSeparate, 0), Value{{src, dst, src, dst}});
+        }
+
+        void APIENTRY blendEquation(GLenum mode)
+        {
+            changeState(F_BlendEquation, key(F_BlendEquationSeparate, 0), Value{{mode, mode}});
+        }
+
+        void APIENTRY viewportHandler(GLint x, GLint y, GLsizei width, GLsizei height)
+        {
+            changeState(F_Viewport, key(F_Viewport, 0), Value{{bits(x), bits(y), bits(width), bits(height)}});
+            viewport[0] = x;
+            viewport[1] = y;
+            viewport[2] = width;
+            viewport[3] = height;
+        }
+
+        void APIENTRY uniform3fv(GLint location, GLsizei count, const GLfloat *value)
+        {
+            changeUniform(F_Uniform3fv, location, value, count * 3 * sizeof(GLfloat));
+        }
+
+        void APIENTRY uniformMatrix4fv(GLint location, GLsizei count, GLboolean, const GLfloat *value)
+        {
+            changeUniform(F_UniformMatrix4fv, location, value, count * 16 * sizeof(GLfloat));
+        }
+
+        void APIENTRY bufferData(GLenum, GLsizeiptr size, const void *, GLenum)
+        {
+            upload(F_BufferData, size);
+        }
+
+        void APIENTRY bufferSubData(GLenum, GLintptr, GLsizeiptr size, const void *)
+        {
+            upload(F_BufferSubData, size);
+        }
+
+        GLsizeiptr pixelSize(GLenum format, GLenum type)
+        {
+            GLsizeiptr components = format == GL_RED || format == GL_DEPTH_COMPONENT ? 1 : format == GL_RG ? 2 : format == GL_RGB ? 3 : 4;
+            return components * (type == GL_UNSIGNED_BYTE ? 1 : type == GL_HALF_FLOAT ? 2 : 4);
+        }
+
+        void APIENTRY texImage2D(GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum format, GLenum type, const void *pixels)
+        {
+            upload(F_TexImage2D, pixels ? width * height * pixelSize(format, type) : 0);
+        }
+
+        void APIENTRY texImage3D(GLenum, GLint, GLint, GLsizei width, GLsizei height, GLsizei depth, GLint, GLenum format, GLenum type, const void *pixels)
+        {
+            upload(F_TexImage3D, pixels ? width * height * depth * pixelSize(format, type) : 0);
+        }
+
+        void APIENTRY compressedTexImage2D(GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei imageSize, const void *)
+        {
+            upload(F_CompressedTexImage2D, imageSize);
+        }
+
+        void APIENTRY compressedTexImage3D(GLenum, GLint, GLenum, GLsizei, GLsizei, GLsizei, GLint, GLsizei imageSize, const void *)
+        {
+            upload(F_CompressedTexImage3D, imageSize);
+        }
+
+        void APIENTRY compressedTexSubImage3D(GLenum, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLsizei imageSize, const void *)
+        {
+            upload(F_CompressedTexSubImage3D, imageSize);
+        }
+
+        void * APIENTRY mapBufferRange(GLenum, GLintptr, GLsizeiptr length, GLbitfield)
+        {
+            record(F_MapBufferRange);
+            mappedRanges.emplace_back(length);
+            return mappedRanges.back().data();
+        }
+
+        GLboolean APIENTRY unmapBuffer(GLenum)
+        {
+            record(F_UnmapBuffer);
+            return GL_TRUE;
+        }
+
+        GLsync APIENTRY fenceSync(GLenum, GLbitfield)
+        {
+            static int fence;
+            record(F_FenceSync);
+            return (GLsync) &fence;
+        }
+
+        GLenum APIENTRY clientWaitSync(GLsync, GLbitfield, GLuint64)
+        {
+            record(F_ClientWaitSync);
+            return GL_ALREADY_SIGNALED;
+        }
+
+        void forgetState()
+        {
+            state.clear();
+            uniformValues.clear();
+        }
+
+        void resetStats(Stats &stats)
+        {
+            stats = Stats();
+            stats.perFunction.assign(NR_OF_FUNCTIONS, 0);
+            stats.redundantPerFunction.assign(NR_OF_FUNCTIONS, 0);
+        }
+    }
+
+    void install()
+    {
+        if (installed) return;
+
+        #define X(name) saved.name = glad_gl##name; glad_gl##name = Ignore<F_##name, decltype(glad_gl##name)>::call;
+        GL_RECORDED_FUNCTIONS(X)
+        #undef X
+
+        #define SETTER(name) glad_gl##name = Setter<F_##name, decltype(glad_gl##name)>::call
+        #define KEYED_SETTER(name) glad_gl##name = KeyedSetter<F_##name, decltype(glad_gl##name)>::call
+        #define DRAW(name) glad_gl##name = Draw<F_##name, decltype(glad_gl##name)>::call
+        #define UNIFORM(name) glad_gl##name = Uniform<F_##name, decltype(glad_gl##name)>::call
+
+        SETTER(BlendEquationSeparate); SETTER(BlendFuncSeparate); SETTER(ClearColor); SETTER(CullFace);
+        SETTER(DepthFunc); SETTER(DepthMask); SETTER(DrawBuffer); SETTER(PolygonOffset); SETTER(ReadBuffer); SETTER(Scissor);
+        KEYED_SETTER(BindBuffer); KEYED_SETTER(BindRenderbuffer); KEYED_SETTER(BindSampler); KEYED_SETTER(PixelStorei); KEYED_SETTER(PolygonMode);
+        DRAW(DrawArrays); DRAW(DrawElements); DRAW(DrawElementsBaseVertex); DRAW(DrawElementsInstanced); DRAW(DrawElementsInstancedBaseVertex);
+        UNIFORM(Uniform1f); UNIFORM(Uniform1i); UNIFORM(Uniform2f); UNIFORM(Uniform3f); UNIFORM(Uniform4f); UNIFORM(Uniform4i);
+        #ifdef GL_VERSION_4_3
+        DRAW(MultiDrawElementsIndirect);
+        #endif
+        #ifdef GL_VERSION_4_5
+        SETTER(ClipControl);
+        #endif
+
+        #undef SETTER
+        #undef KEYED_SETTER
+        #undef DRAW
+        #undef UNIFORM
+
+        glad_glGenBuffers = genNames<F_GenBuffers>;
+        glad_glGenFramebuffers = genNames<F_GenFramebuffers>;
+        glad_glGenQueries = genNames<F_GenQueries>;
+        glad_glGenRenderbuffers = genNames<F_GenRenderbuffers>;
+        glad_glGenTextures = genNames<F_GenTextures>;
+        glad_glGenVertexArrays = genNames<F_GenVertexArrays>;
+        glad_glCreateProgram = createProgram;
+        glad_glCreateShader = createShader;
+        glad_glShaderSource = shaderSource;
+        glad_glAttachShader = attachShader;
+        glad_glDetachShader = detachShader;
+        glad_glLinkProgram = linkProgram;
+
+        glad_glGetProgramiv = getProgramiv;
+        glad_glGetShaderiv = getShaderiv;
+        glad_glGetProgramInfoLog = getInfoLog<F_GetProgramInfoLog>;
+        glad_glGetShaderInfoLog = getInfoLog<F_GetShaderInfoLog>;
+        glad_glGetActiveUniform = getActiveUniform;
+        glad_glGetUniformLocation = getUniformLocation;
+        glad_glGetUniformBlockIndex = getUniformBlockIndex;
+        glad_glGetAttribLocation = getAttribLocation;
+        glad_glGetIntegerv = getIntegerv;
+        glad_glGetQueryObjectiv = getQueryObjectiv;
+        glad_glGetQueryObjectui64v = getQueryObjectui64v;
+        glad_glGetString = getString;
+        glad_glIsEnabled = isEnabled;
+
+        glad_glEnable = enable;
+        glad_glDisable = disable;
+        glad_glUseProgram = useProgram;
+        glad_glActiveTexture = activeTexture;
+        glad_glBindTexture = bindTexture;
+        glad_glBindVertexArray = bindVertexArray;
+        glad_glBindBufferRange = bindBufferRange;
+        glad_glBindFramebuffer = bindFramebuffer;
+        glad_glBlendFunc = blendFunc;
+        glad_glBlendEquation = blendEquation;
+        glad_glViewport = viewportHandler;
+
+        glad_glUniform3fv = uniform3fv;
+        glad_glUniformMatrix4fv = uniformMatrix4fv;
+        glad_glBufferData = bufferData;
+        glad_glBufferSubData = bufferSubData;
+        glad_glTexImage2D = texImage2D;
+        glad_glTexImage3D = texImage3D;
+        glad_glCompressedTexImage2D = compressedTexImage2D;
+        glad_glCompressedTexImage3D = compressedTexImage3D;
+        glad_glCompressedTexSubImage3D = compressedTexSubImage3D;
+        glad_glMapBufferRange = mapBufferRange;
+        glad_glUnmapBuffer = unmapBuffer;
+        glad_glFenceSync = fenceSync;
+        glad_glClientWaitSync = clientWaitSync;
+
+        for (size_t i = 0; flags[i]; i++)
+        {
+            savedFlags[i] = *flags[i];
+            *flags[i] = 0;
+        }
+
+        installed = true;
+        resetStats(current);
+        resetStats(last);
+        calls.clear();
+        lastCalls.clear();
+        forgetState();
+
+        // The cache could hold state of a real context
+        GLState::invalidate();
+    }
+
+    void uninstall()
+    {
+        if (!installed) return;
+
+        #define X(name) glad_gl##name = saved.name;
+        GL_RECORDED_FUNCTIONS(X)
+        #undef X
+
+        for (size_t i = 0; flags[i]; i++) *flags[i] = savedFlags[i];
+
+        installed = false;
+        forgetState();
+        sources.clear();
+        attached.clear();
+        programs.clear();
+        mappedRanges.clear();
+
+        GLState::invalidate();
+    }
+
+    bool isInstalled()
+    {
+        return installed;
+    }
+
+    void setCapture(bool enabled)
+    {
+        capture = enabled;
+    }
+
+    void nextFrame()
+    {
+        last = current;
+        resetStats(current);
+
+        lastCalls.swap(calls);
+        calls.clear();
+
+        forgetState();
+    }
+
+    const Stats & getLastFrameStats()
+    {
+        return last;
+    }
+
+    const std::vector<Call> & getLastFrameCalls()
+    {
+        return lastCalls;
+    }
+
+    unsigned int nrOfFunctions()
+    {
+        return NR_OF_FUNCTIONS;
+    }
+
+    const char * functionName(unsigned int function)
+    {
+        return names[function];
+    }
+}
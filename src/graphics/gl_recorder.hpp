@@ -0,0 +1,77 @@
+#pragma once
+
+// Standard Headers
+#include <vector>
+
+/**
+ * OpenGL backend that records the calls instead of making them, and needs no context.
+ *
+ * install() points the glad function pointers of every GL function used by the renderers, GLState and the
+ * ImGui backend to recording functions, so Scene::draw() runs unchanged on a machine without a GPU.
+ * Nothing is drawn: object names come from a counter, compiling and linking always succeeds and the
+ * uniforms of a program are found by scanning its GLSL source, so Shader::reflect() sees the same names as on a driver.
+ *
+ * Every call is counted. Binds, enables and the other pipeline state, and uniform uploads, are compared with the value
+ * that is already set: a call that sets the current value again (or a uniform at location -1) is redundant.
+ * The recorded state is forgotten at the start of every frame, like GLState::invalidate(), so only
+ * redundancy within a frame is reported.
+ *
+ * Used by the headless mode with --record-gl, to benchmark the CPU side of a frame and to catch redundant state changes.
+ */
+namespace GLRecorder
+{
+    struct Stats {
+        unsigned int calls = 0, draws = 0;
+
+        // Calls that change pipeline state (binds, enables, blend and depth functions, viewport...), and the ones
+        // that did not change anything
+        unsigned int stateChanges = 0, redundantStateChanges = 0;
+        unsigned int uniforms = 0, redundantUniforms = 0;
+
+        // Buffer and texture uploads, and the bytes they sent
+        unsigned int uploads = 0;
+        unsigned long long uploadedBytes = 0;
+
+        // Calls and redundant calls per function, indexed like functionName()
+        std::vector<unsigned int> perFunction, redundantPerFunction;
+    };
+
+    struct Call {
+        unsigned int function;
+        bool redundant;
+    };
+
+    /**
+     * Replaces the glad function pointers, until uninstall(). Works without a context and without gladLoadGL().
+     * The version and extension flags of glad are cleared meanwhile, so the renderers take their GL 3.3 paths.
+     */
+    void install();
+
+    void uninstall();
+
+    bool isInstalled();
+
+    /**
+     * Keeps the list of calls of the frames from now on, off by default because it costs a push_back per call.
+     */
+    void setCapture(bool enabled);
+
+    /**
+     * Stores the stats (and calls) of the frame that just ended, resets them and forgets the recorded state.
+     */
+    void nextFrame();
+
+    const Stats & getLastFrameStats();
+
+    /**
+     * Empty unless capturing was enabled during the last frame.
+     */
+    const std::vector<Call> & getLastFrameCalls();
+
+    unsigned int nrOfFunctions();
+
+    /**
+     * Name of a recorded function, including the gl prefix.
+     */
+    const char * functionName(unsigned int function);
+}
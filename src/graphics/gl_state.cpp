@@ -0,0 +1,189 @@
+#include "gl_state.hpp"
+
+// Local Headers
+#include "graphics/imgui/imgui.h"
+
+namespace GLState
+{
+    namespace
+    {
+        const GLuint UNKNOWN = ~0u;
+        const unsigned int MAX_TEXTURE_UNITS = 16, NR_OF_TARGETS = 3;
+
+        Stats current, last;
+
+        GLuint program = UNKNOWN, vao = UNKNOWN, activeUnit = UNKNOWN;
+        GLuint textures[MAX_TEXTURE_UNITS][NR_OF_TARGETS];
+
+        GLuint blend = UNKNOWN, depthTest = UNKNOWN, depthMask = UNKNOWN;
+        GLenum blendSrc = UNKNOWN, blendDst = UNKNOWN, depthFunc = UNKNOWN;
+
+        int targetIndex(GLenum target)
+        {
+            switch (target)
+            {
+                case GL_TEXTURE_2D: return 0;
+                case GL_TEXTURE_2D_ARRAY: return 1;
+                case GL_TEXTURE_CUBE_MAP: return 2;
+                default: return -1;
+            }
+        }
+
+        // Sets the cached value and returns true if the GL call has to be made
+        bool change(GLuint &cached, GLuint value, unsigned int &issued, unsigned int &elided)
+        {
+            if (cached == value)
+            {
+                elided++;
+                return false;
+            }
+            cached = value;
+            issued++;
+            return true;
+        }
+
+        void setCapability(GLenum capability, GLuint &cached, bool enabled, unsigned int &issued, unsigned int &elided)
+        {
+            if (!change(cached, enabled, issued, elided)) return;
+            if (enabled) glEnable(capability);
+            else glDisable(capability);
+        }
+
+        struct Init { Init() { invalidate(); } } init;
+    }
+
+    void useProgram(GLuint id)
+    {
+        if (change(program, id, current.issued.programs, current.elided.programs))
+            glUseProgram(id);
+    }
+
+    void bindTexture(GLuint unit, GLenum target, GLuint id)
+    {
+        int t = targetIndex(target);
+        if (t == -1 || unit >= MAX_TEXTURE_UNITS)
+        {
+            // Not cached, so the cached active unit is no longer known
+            glActiveTexture(GL_TEXTURE0 + unit);
+            glBindTexture(target, id);
+            activeUnit = unit;
+            current.issued.textures++;
+            return;
+        }
+
+        if (!change(textures[unit][t], id, current.issued.textures, current.elided.textures)) return;
+
+        if (activeUnit != unit)
+        {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            activeUnit = unit;
+        }
+        glBindTexture(target, id);
+    }
+
+    void bindVertexArray(GLuint id)
+    {
+        if (change(vao, id, current.issued.vertexArrays, current.elided.vertexArrays))
+            glBindVertexArray(id);
+    }
+
+    void onVertexArrayDeleted(GLuint id)
+    {
+        if (vao == id) vao = 0;
+    }
+
+    void setBlend(bool enabled)
+    {
+        setCapability(GL_BLEND, blend, enabled, current.issued.blend, current.elided.blend);
+    }
+
+    void setBlendFunc(GLenum src, GLenum dst)
+    {
+        if (blendSrc == src && blendDst == dst)
+        {
+            current.elided.blend++;
+            return;
+        }
+        blendSrc = src;
+        blendDst = dst;
+        current.issued.blend++;
+        glBlendFunc(src, dst);
+    }
+
+    void setDepthTest(bool enabled)
+    {
+        setCapability(GL_DEPTH_TEST, depthTest, enabled, current.issued.depth, current.elided.depth);
+    }
+
+    void setDepthMask(bool enabled)
+    {
+        if (change(depthMask, enabled, current.issued.depth, current.elided.depth))
+            glDepthMask(enabled);
+    }
+
+    void setDepthFunc(GLenum func)
+    {
+        if (change(depthFunc, func, current.issued.depth, current.elided.depth))
+            glDepthFunc(func);
+    }
+
+    void countDraw(unsigned int meshes)
+    {
+        current.draws++;
+        current.meshes += meshes;
+    }
+
+    void invalidate()
+    {
+        program = vao = activeUnit = UNKNOWN;
+        for (auto &unit : textures)
+            for (GLuint &id : unit) id = UNKNOWN;
+
+        blend = depthTest = depthMask = UNKNOWN;
+        blendSrc = blendDst = depthFunc = UNKNOWN;
+    }
+
+    void nextFrame()
+    {
+        last = current;
+        current = Stats();
+    }
+
+    const Stats & getLastFrameStats()
+    {
+        return last;
+    }
+
+    void ShowDebugWindow(bool* p_open)
+    {
+        ImGui::SetNextWindowSize(ImVec2(300, 200), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Render State", p_open))
+        {
+            ImGui::End();
+            return;
+        }
+
+        ImGui::Text("Draws: %u (%u meshes)", last.draws, last.meshes);
+        ImGui::Separator();
+
+        ImGui::Columns(3);
+        ImGui::Text("State"); ImGui::NextColumn();
+        ImGui::Text("Issued"); ImGui::NextColumn();
+        ImGui::Text("Elided"); ImGui::NextColumn();
+        ImGui::Separator();
+
+        const char *names[] = {"Programs", "Textures", "Vertex arrays", "Blend", "Depth"};
+        const unsigned int issued[] = {last.issued.programs, last.issued.textures, last.issued.vertexArrays, last.issued.blend, last.issued.depth};
+        const unsigned int elided[] = {last.elided.programs, last.elided.textures, last.elided.vertexArrays, last.elided.blend, last.elided.depth};
+
+        for (int i = 0; i < 5; i++)
+        {
+            ImGui::Text("%s", names[i]); ImGui::NextColumn();
+            ImGui::Text("%u", issued[i]); ImGui::NextColumn();
+            ImGui::Text("%u", elided[i]); ImGui::NextColumn();
+        }
+        ImGui::Columns(1);
+
+        ImGui::End();
+    }
+}
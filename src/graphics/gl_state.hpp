@@ -0,0 +1,58 @@
+#pragma once
+
+// System Headers
+#include <glad/glad.h>
+
+/**
+ * Cache of the GL state that changes between passes and draws.
+ *
+ * Every call compares with the last value that was set and skips the GL call when nothing changes.
+ * The cache only knows about changes that go through it, so code that calls glUseProgram, glBindTexture,
+ * glBindVertexArray, glEnable(GL_BLEND/GL_DEPTH_TEST), glBlendFunc or glDepth* directly has to call invalidate() afterwards.
+ * Scene::draw() invalidates at the start of every frame, because ImGui renders with its own state.
+ */
+namespace GLState
+{
+    struct Counters {
+        unsigned int programs = 0, textures = 0, vertexArrays = 0, blend = 0, depth = 0;
+    };
+
+    struct Stats {
+        // GL calls that were made, and the ones that were skipped because the state was already set
+        Counters issued, elided;
+        // Draw calls, and the meshes they drew. A multi draw is one call for several meshes
+        unsigned int draws = 0, meshes = 0;
+    };
+
+    void useProgram(GLuint program);
+
+    void bindTexture(GLuint unit, GLenum target, GLuint id);
+
+    void bindVertexArray(GLuint vao);
+
+    // Called when a vertex array is deleted, GL falls back to 0 if it was bound
+    void onVertexArrayDeleted(GLuint vao);
+
+    void setBlend(bool enabled);
+    void setBlendFunc(GLenum src, GLenum dst);
+
+    void setDepthTest(bool enabled);
+    void setDepthMask(bool enabled);
+    void setDepthFunc(GLenum func);
+
+    void countDraw(unsigned int meshes = 1);
+
+    /**
+     * Forgets all cached state, the next call of every setter is issued.
+     */
+    void invalidate();
+
+    /**
+     * Stores the counters of the frame that just ended and resets them.
+     */
+    void nextFrame();
+
+    const Stats & getLastFrameStats();
+
+    void ShowDebugWindow(bool* p_open);
+}
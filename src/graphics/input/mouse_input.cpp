@@ -150,11 +150,14 @@ void update()
 
 void setLockedMode(bool lockedMode)
 {
+    // No window in headless mode
+    if (!window) return;
     glfwSetInputMode(window, GLFW_CURSOR, lockedMode ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
 }
 
 void setMousePos(double x, double y)
 {
+    if (!window) return;
     glfwSetCursorPos(window, x, y);
 }
 
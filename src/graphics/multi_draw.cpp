@@ -0,0 +1,130 @@
+#include "multi_draw.hpp"
+
+// Standard Headers
+#include <algorithm>
+
+// Local Headers
+#include "geometry/mesh.hpp"
+#include "graphics/vert_buffer.hpp"
+#include "graphics/gl_state.hpp"
+#include "graphics/gl_error.hpp"
+
+bool MultiDraw::supported()
+{
+    #ifdef GL_VERSION_4_3
+    return GLAD_GL_VERSION_4_3 && GLAD_GL_ARB_shader_draw_parameters;
+    #else
+    return false;
+    #endif
+}
+
+const char *MultiDraw::vertexHeader()
+{
+    // #line keeps the line numbers in compile errors the same as in the file
+    return
+        "#version 430 core\n"
+        "#extension GL_ARB_shader_draw_parameters : require\n"
+        "#define MULTI_DRAW\n"
+        "layout(std430, binding = 0) readonly buffer PerDraw {\n"
+        "    mat4 models[];\n"
+        "};\n"
+        "#define model models[gl_DrawIDARB]\n"
+        "#line 2\n";
+}
+
+MultiDraw::~MultiDraw()
+{
+    if (indirectBuffer) glDeleteBuffers(1, &indirectBuffer);
+    if (perDrawBuffer) glDeleteBuffers(1, &perDrawBuffer);
+}
+
+void MultiDraw::add(const Mesh &mesh, const glm::mat4 &model)
+{
+    if (!runOpen)
+    {
+        runs.push_back({mesh.vertBuffer, mesh.mode, (unsigned int) commands.size(), 0, (unsigned int) models.size()});
+        runOpen = true;
+    }
+    Run &run = runs.back();
+    if (mesh.vertBuffer != run.vertBuffer || mesh.mode != run.mode)
+        throw mesh.name + " is not in the VertBuffer of the other meshes of its multi draw";
+
+    // baseInstance is unused, the shader only needs gl_DrawIDARB
+    commands.push_back({mesh.nrOfIndices, 1, mesh.indicesBufferOffset / (GLuint) sizeof(GLushort), mesh.baseVertex, 0});
+    models.push_back(model);
+    run.nrOfCommands++;
+}
+
+unsigned int MultiDraw::endRun()
+{
+    if (!runOpen) throw "MultiDraw::endRun() without a draw";
+    runOpen = false;
+
+    #ifdef GL_VERSION_4_3
+    if (!modelAlignment)
+    {
+        GLint alignment = 256;
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        modelAlignment = std::max(1u, (unsigned int) (alignment + sizeof(glm::mat4) - 1) / (unsigned int) sizeof(glm::mat4));
+    }
+    #endif
+
+    // gl_DrawIDARB starts at 0 for every run, so every run gets its own range of the storage buffer
+    while (modelAlignment > 1 && models.size() % modelAlignment) models.emplace_back(1.f);
+
+    return runs.size() - 1;
+}
+
+void MultiDraw::upload()
+{
+    if (runs.empty()) return;
+
+    #ifdef GL_VERSION_4_3
+    if (!indirectBuffer)
+    {
+        glGenBuffers(1, &indirectBuffer);
+        glGenBuffers(1, &perDrawBuffer);
+    }
+
+    // Orphan the storage that the draws of the previous flush may still read, then fill the new storage
+    GLsizeiptr commandsSize = commands.size() * sizeof(Command), modelsSize = models.size() * sizeof(glm::mat4);
+    indirectCapacity = std::max(indirectCapacity, commandsSize);
+    perDrawCapacity = std::max(perDrawCapacity, modelsSize);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, indirectCapacity, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commandsSize, commands.data());
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, perDrawBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, perDrawCapacity, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, modelsSize, models.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    check_gl_error();
+    #endif
+}
+
+void MultiDraw::draw(unsigned int runIndex)
+{
+    #ifdef GL_VERSION_4_3
+    const Run &run = runs[runIndex];
+
+    run.vertBuffer->bind();
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, PER_DRAW_BINDING, perDrawBuffer,
+        run.firstModel * sizeof(glm::mat4), run.nrOfCommands * sizeof(glm::mat4));
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glMultiDrawElementsIndirect(run.mode, GL_UNSIGNED_SHORT,
+        (void *)(uintptr_t) (run.firstCommand * sizeof(Command)), run.nrOfCommands, 0);
+
+    GLState::countDraw(run.nrOfCommands);
+    check_gl_error();
+    #endif
+}
+
+void MultiDraw::clear()
+{
+    commands.clear();
+    models.clear();
+    runs.clear();
+    runOpen = false;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+// System Headers
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+
+// Standard Headers
+#include <vector>
+
+class Mesh;
+class VertBuffer;
+
+/**
+ * Draws runs of meshes that share a VertBuffer with one glMultiDrawElementsIndirect() per run.
+ *
+ * The model matrix of every draw goes into a shader storage buffer that the vertex shader indexes with gl_DrawIDARB,
+ * so the meshes of a run need no uniform changes in between.
+ * Needs GL 4.3 and ARB_shader_draw_parameters, without them supported() is false and
+ * the RenderQueue draws every mesh on its own with the model uniform.
+ *
+ * Vertex shaders opt in by declaring their model uniform like this:
+ *
+ * #ifndef MULTI_DRAW
+ * uniform mat4 model;
+ * #endif
+ *
+ * When multi draw is supported, Shader::init() replaces their #version line with vertexHeader(),
+ * which defines `model` as the matrix of the current draw.
+ */
+class MultiDraw
+{
+  public:
+    // Binding point of the PerDraw storage block
+    static const GLuint PER_DRAW_BINDING = 0;
+
+    static bool supported();
+
+    static const char *vertexHeader();
+
+    ~MultiDraw();
+
+    /**
+     * Adds a draw of the mesh to the current run.
+     * All meshes of a run have to be in the same VertBuffer and have the same mode.
+     */
+    void add(const Mesh &mesh, const glm::mat4 &model);
+
+    /**
+     * Ends the current run and returns its index for draw().
+     */
+    unsigned int endRun();
+
+    /**
+     * Uploads the commands and models of all runs, call once after the last endRun().
+     */
+    void upload();
+
+    void draw(unsigned int run);
+
+    /**
+     * Removes all runs, the buffers keep their size for the next frame.
+     */
+    void clear();
+
+  private:
+    // Layout of glMultiDrawElementsIndirect
+    struct Command {
+        GLuint count, instanceCount, firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    struct Run {
+        VertBuffer *vertBuffer;
+        GLenum mode;
+        unsigned int firstCommand, nrOfCommands, firstModel;
+    };
+
+    std::vector<Command> commands;
+    std::vector<glm::mat4> models;
+    std::vector<Run> runs;
+    bool runOpen = false;
+
+    GLuint indirectBuffer = 0, perDrawBuffer = 0;
+    GLsizeiptr indirectCapacity = 0, perDrawCapacity = 0;
+
+    // GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT in matrices, every run starts at a multiple of it
+    unsigned int modelAlignment = 0;
+};
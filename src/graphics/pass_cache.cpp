@@ -0,0 +1,21 @@
+#include "pass_cache.hpp"
+
+bool PassInputs::operator==(const PassInputs &other) const
+{
+    return viewProjection == other.viewProjection
+        && transforms == other.transforms
+        && meshes == other.meshes
+        && time == other.time;
+}
+
+bool PassCache::needsUpdate(const PassInputs &inputs)
+{
+    framesSinceUpdate++;
+
+    if (valid && (inputs == last || framesSinceUpdate < interval)) return false;
+
+    last = inputs;
+    valid = true;
+    framesSinceUpdate = 0;
+    return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// Standard Headers
+#include <glm/mat4x4.hpp>
+
+/**
+ * Everything an offscreen pass depends on, see PassCache.
+ */
+struct PassInputs {
+    // Camera of the pass, for the shadow cascades this includes the position of the sun
+    glm::mat4 viewProjection;
+
+    // RenderView::getTransformVersion(), changes when a body moves
+    unsigned int transforms;
+
+    // VertBuffer::getUploadVersion(), changes when meshes are uploaded or destroyed
+    unsigned int meshes;
+
+    // Simulation time, for passes that animate (0 for passes that do not)
+    double time;
+
+    bool operator==(const PassInputs &other) const;
+    bool operator!=(const PassInputs &other) const { return !(*this == other); }
+};
+
+/**
+ * Remembers the inputs an offscreen pass was last drawn with, so the pass can keep its old target
+ * while the simulation is paused and the camera is still.
+ *
+ * When the inputs keep changing the pass can be amortized: with an interval of n it is redrawn
+ * at most once every n frames, the frames in between reuse the last result.
+ */
+class PassCache
+{
+  public:
+    PassCache(unsigned int interval = 1): interval(interval) {}
+
+    // Redraw at most once every interval frames while the inputs keep changing, 1 redraws every frame they change
+    unsigned int interval;
+
+    /**
+     * Call once per frame. Returns true when the pass has to be drawn with these inputs
+     * (and remembers them), false when its target still holds the result.
+     */
+    bool needsUpdate(const PassInputs &inputs);
+
+    // Forces a redraw the next frame, for changes the inputs do not cover
+    void invalidate() { valid = false; }
+
+  private:
+    PassInputs last;
+    bool valid = false;
+    unsigned int framesSinceUpdate = 0;
+};
@@ -0,0 +1,437 @@
+#include "profiler.hpp"
+
+// System Headers
+#include <glad/glad.h>
+
+// Standard Headers
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+// Local Headers
+#include "graphics/imgui/imgui.h"
+
+namespace Profiler
+{
+    namespace
+    {
+        const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+        // Thread id of the GPU in the exports
+        const unsigned int GPU_THREAD = 1000;
+
+        double now()
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - epoch).count();
+        }
+
+        std::mutex mutex;
+
+        // Guarded by the mutex
+        std::unordered_set<std::string> names;
+        std::vector<Sample> pending;
+
+        std::atomic<unsigned int> nrOfThreads(0);
+        thread_local unsigned int thread = nrOfThreads++;
+        thread_local unsigned int depth = 0;
+
+        // Everything below is only used by the render thread
+        unsigned int renderThread = 0;
+
+        std::deque<Frame> history;
+        unsigned long long nextFrameIndex = 0;
+        double frameStart = 0;
+
+        // The queries of one frame, the ids are reused when the frame comes around again
+        struct GpuQueries {
+            unsigned long long frame = 0;
+            std::vector<GLuint> ids;
+            std::vector<const char *> names;
+        };
+        GpuQueries ring[FRAMES_IN_FLIGHT];
+        unsigned int currentQueries = 0;
+        bool gpuScopeActive = false;
+        unsigned long long droppedQueries = 0;
+
+        const char * intern(const std::string &name)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return names.insert(name).first->c_str();
+        }
+
+        Frame * findFrame(unsigned long long index)
+        {
+            if (history.empty() || index < history.front().index || index > history.back().index) return NULL;
+            return &history[index - history.front().index];
+        }
+
+        void readQueries(GpuQueries &queries)
+        {
+            Frame *frame = findFrame(queries.frame);
+
+            for (size_t i = 0; i < queries.names.size(); i++)
+            {
+                // Waiting for GL_QUERY_RESULT would stall the pipeline
+                GLint available = 0;
+                glGetQueryObjectiv(queries.ids[i], GL_QUERY_RESULT_AVAILABLE, &available);
+                if (!available)
+                {
+                    droppedQueries++;
+                    continue;
+                }
+
+                GLuint64 elapsed = 0;
+                glGetQueryObjectui64v(queries.ids[i], GL_QUERY_RESULT, &elapsed);
+                if (frame) frame->gpu.push_back({queries.names[i], elapsed / 1e6});
+            }
+            queries.names.clear();
+        }
+
+        ImU32 color(const char *name)
+        {
+            float r, g, b;
+            ImGui::ColorConvertHSVtoRGB((std::hash<std::string>()(name) % 360) / 360.f, .45f, .85f, r, g, b);
+            return ImGui::ColorConvertFloat4ToU32(ImVec4(r, g, b, 1));
+        }
+
+        std::string escape(const char *name)
+        {
+            std::string escaped;
+            for (const char *c = name; *c; c++)
+            {
+                if (*c == '"' || *c == '\\') escaped += '\\';
+                escaped += *c;
+            }
+            return escaped;
+        }
+
+        /**
+         * Bars of the samples on a lane per thread, and the passes on the GPU below them.
+         */
+        void ShowTimeline(const Frame &frame)
+        {
+            // Rows a thread needs, one for its name and one per level of nesting
+            std::map<unsigned int, unsigned int> lanes;
+            for (const Sample &sample : frame.cpu)
+                lanes[sample.thread] = std::max(lanes[sample.thread], sample.depth + 1);
+
+            unsigned int rows = 2;
+            for (auto &lane : lanes) rows += lane.second + 1;
+
+            const float rowHeight = ImGui::GetTextLineHeight() + 4;
+            const float width = std::max(ImGui::GetContentRegionAvail().x, 100.f);
+
+            ImVec2 origin = ImGui::GetCursorScreenPos();
+            ImGui::InvisibleButton("timeline", ImVec2(width, rows * rowHeight));
+            bool hovered = ImGui::IsItemHovered();
+            ImVec2 mouse = ImGui::GetIO().MousePos;
+
+            ImDrawList *draw = ImGui::GetWindowDrawList();
+            ImU32 textColor = ImGui::GetColorU32(ImGuiCol_Text);
+
+            // Pixels per millisecond
+            double scale = width / std::max(frame.duration, 1e-3);
+
+            // start in milliseconds since the start of the frame, samples of other threads can start in an earlier frame
+            auto bar = [&](const char *name, double start, double duration, float y) {
+                float x0 = origin.x + std::max(0., start) * scale;
+                float x1 = origin.x + std::min(frame.duration, start + duration) * scale;
+
+                ImVec2 min(x0, y), max(std::max(x1, x0 + 1), y + rowHeight - 1);
+                draw->AddRectFilled(min, max, color(name));
+
+                ImVec4 clip(min.x, min.y, max.x, max.y);
+                draw->AddText(NULL, 0.f, ImVec2(min.x + 2, min.y + 2), IM_COL32_BLACK, name, NULL, 0.f, &clip);
+
+                if (hovered && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+                    ImGui::SetTooltip("%s: %.3f ms", name, duration);
+            };
+
+            float y = origin.y;
+            for (auto &lane : lanes)
+            {
+                draw->AddText(ImVec2(origin.x, y), textColor, threadName(lane.first).c_str());
+                y += rowHeight;
+
+                for (const Sample &sample : frame.cpu)
+                    if (sample.thread == lane.first) bar(sample.name, sample.start - frame.start, sample.duration, y + sample.depth * rowHeight);
+                y += lane.second * rowHeight;
+            }
+
+            draw->AddText(ImVec2(origin.x, y), textColor, frame.gpu.empty() ? "gpu (not read yet)" : "gpu");
+            y += rowHeight;
+
+            double gpuStart = 0;
+            for (const GpuSample &sample : frame.gpu)
+            {
+                bar(sample.name, gpuStart, sample.duration, y);
+                gpuStart += sample.duration;
+            }
+        }
+
+        /**
+         * Time per frame of every scope, averaged over the frames.
+         */
+        void ShowAverages(const std::deque<Frame> &frames)
+        {
+            struct Total {
+                double cpu = 0, cpuMax = 0, gpu = 0;
+            };
+            std::unordered_map<const char *, Total> totals;
+            unsigned int gpuFrames = 0;
+
+            for (const Frame &frame : frames)
+            {
+                for (const Sample &sample : frame.cpu)
+                {
+                    Total &total = totals[sample.name];
+                    total.cpu += sample.duration;
+                    total.cpuMax = std::max(total.cpuMax, sample.duration);
+                }
+                for (const GpuSample &sample : frame.gpu) totals[sample.name].gpu += sample.duration;
+                if (!frame.gpu.empty()) gpuFrames++;
+            }
+
+            std::vector<std::pair<const char *, Total>> rows(totals.begin(), totals.end());
+            std::sort(rows.begin(), rows.end(), [](const std::pair<const char *, Total> &a, const std::pair<const char *, Total> &b) {
+                return a.second.cpu + a.second.gpu > b.second.cpu + b.second.gpu;
+            });
+
+            ImGui::Columns(4);
+            ImGui::Text("Scope"); ImGui::NextColumn();
+            ImGui::Text("CPU ms/frame"); ImGui::NextColumn();
+            ImGui::Text("CPU max ms"); ImGui::NextColumn();
+            ImGui::Text("GPU ms/frame"); ImGui::NextColumn();
+            ImGui::Separator();
+
+            for (auto &row : rows)
+            {
+                ImGui::Text("%s", row.first); ImGui::NextColumn();
+                ImGui::Text("%.3f", row.second.cpu / frames.size()); ImGui::NextColumn();
+                ImGui::Text("%.3f", row.second.cpuMax); ImGui::NextColumn();
+                if (gpuFrames && row.second.gpu > 0) ImGui::Text("%.3f", row.second.gpu / gpuFrames);
+                else ImGui::Text("-");
+                ImGui::NextColumn();
+            }
+            ImGui::Columns(1);
+        }
+    }
+
+    CpuScope::CpuScope(const char *name) : name(name), start(now())
+    {
+        depth++;
+    }
+
+    CpuScope::CpuScope(const std::string &name) : CpuScope(intern(name)) {}
+
+    CpuScope::~CpuScope()
+    {
+        depth--;
+        Sample sample = {name, thread, depth, start, now() - start};
+
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(sample);
+    }
+
+    GpuScope::GpuScope(const char *name)
+    {
+        if (gpuScopeActive) throw "Profiler: GPU scope " + std::string(name) + " is inside another one, GL_TIME_ELAPSED queries can not nest";
+
+        GpuQueries &queries = ring[currentQueries];
+        if (queries.names.size() == queries.ids.size())
+        {
+            queries.ids.push_back(0);
+            glGenQueries(1, &queries.ids.back());
+        }
+
+        glBeginQuery(GL_TIME_ELAPSED, queries.ids[queries.names.size()]);
+        queries.names.push_back(name);
+        gpuScopeActive = true;
+    }
+
+    GpuScope::GpuScope(const std::string &name) : GpuScope(intern(name)) {}
+
+    GpuScope::~GpuScope()
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        gpuScopeActive = false;
+    }
+
+    void nextFrame()
+    {
+        renderThread = thread;
+        double end = now();
+
+        Frame frame;
+        frame.index = nextFrameIndex++;
+        frame.start = frameStart;
+        frame.duration = end - frameStart;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            frame.cpu.swap(pending);
+        }
+        frameStart = end;
+
+        history.push_back(std::move(frame));
+        if (history.size() > HISTORY_SIZE) history.pop_front();
+
+        // The queries of this frame are read when its slot comes around again, FRAMES_IN_FLIGHT - 1 frames from now
+        ring[currentQueries].frame = history.back().index;
+        currentQueries = (currentQueries + 1) % FRAMES_IN_FLIGHT;
+        readQueries(ring[currentQueries]);
+    }
+
+    const std::deque<Frame> & getHistory()
+    {
+        return history;
+    }
+
+    const Frame * lastCompleteFrame()
+    {
+        if (history.size() < FRAMES_IN_FLIGHT) return NULL;
+        return &history[history.size() - FRAMES_IN_FLIGHT];
+    }
+
+    std::string threadName(unsigned int id)
+    {
+        if (id == GPU_THREAD) return "gpu";
+        return id == renderThread ? "render" : "worker " + std::to_string(id);
+    }
+
+    void exportCsv(const std::string &path)
+    {
+        std::ofstream csv(path);
+        csv << "frame,thread,name,depth,start_ms,duration_ms\n";
+
+        for (const Frame &frame : history)
+        {
+            for (const Sample &sample : frame.cpu)
+                csv << frame.index << "," << threadName(sample.thread) << "," << sample.name << "," << sample.depth << ","
+                    << sample.start - frame.start << "," << sample.duration << "\n";
+
+            double gpuStart = 0;
+            for (const GpuSample &sample : frame.gpu)
+            {
+                csv << frame.index << "," << threadName(GPU_THREAD) << "," << sample.name << ",0," << gpuStart << "," << sample.duration << "\n";
+                gpuStart += sample.duration;
+            }
+        }
+    }
+
+    void exportChromeTrace(const std::string &path)
+    {
+        std::ofstream json(path);
+        json << std::fixed << std::setprecision(3);
+        json << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+
+        bool first = true;
+        std::set<unsigned int> threads;
+
+        // Complete events, in microseconds
+        auto event = [&](const char *name, unsigned int tid, double start, double duration) {
+            json << (first ? "" : ",\n") << "{\"name\": \"" << escape(name) << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << tid
+                 << ", \"ts\": " << start * 1000 << ", \"dur\": " << duration * 1000 << "}";
+            first = false;
+            threads.insert(tid);
+        };
+
+        for (const Frame &frame : history)
+        {
+            for (const Sample &sample : frame.cpu) event(sample.name, sample.thread, sample.start, sample.duration);
+
+            double gpuStart = frame.start;
+            for (const GpuSample &sample : frame.gpu)
+            {
+                event(sample.name, GPU_THREAD, gpuStart, sample.duration);
+                gpuStart += sample.duration;
+            }
+        }
+
+        for (unsigned int tid : threads)
+        {
+            json << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << tid
+                 << ", \"args\": {\"name\": \"" << threadName(tid) << "\"}}";
+            first = false;
+        }
+        json << "\n]}\n";
+    }
+
+    void ShowWindow(bool* p_open)
+    {
+        ImGui::SetNextWindowSize(ImVec2(700, 500), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Profiler", p_open))
+        {
+            ImGui::End();
+            return;
+        }
+
+        // Frames before the newest one, the newest frames have no GPU times yet
+        static int selected = FRAMES_IN_FLIGHT - 1;
+        static bool paused = false;
+        static std::deque<Frame> frozen;
+        static std::string exported;
+
+        if (ImGui::Checkbox("Pause", &paused) && paused) frozen = history;
+        const std::deque<Frame> &frames = paused ? frozen : history;
+
+        ImGui::SameLine();
+        if (ImGui::Button("Export CSV"))
+        {
+            exportCsv("profile.csv");
+            exported = "profile.csv";
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Export Chrome trace"))
+        {
+            exportChromeTrace("profile.json");
+            exported = "profile.json";
+        }
+        if (!exported.empty())
+        {
+            ImGui::SameLine();
+            ImGui::Text("Wrote %s", exported.c_str());
+        }
+
+        if (frames.empty())
+        {
+            ImGui::Text("No frames yet");
+            ImGui::End();
+            return;
+        }
+
+        std::vector<float> cpuTimes, gpuTimes;
+        for (const Frame &frame : frames)
+        {
+            cpuTimes.push_back(frame.duration);
+
+            float gpu = 0;
+            for (const GpuSample &sample : frame.gpu) gpu += sample.duration;
+            gpuTimes.push_back(gpu);
+        }
+        ImGui::PlotLines("Frame ms", cpuTimes.data(), cpuTimes.size(), 0, NULL, 0, FLT_MAX, ImVec2(0, 50));
+        ImGui::PlotLines("GPU ms", gpuTimes.data(), gpuTimes.size(), 0, NULL, 0, FLT_MAX, ImVec2(0, 50));
+        if (droppedQueries) ImGui::Text("%llu GPU queries were not ready in time and dropped", droppedQueries);
+
+        selected = std::min(selected, (int) frames.size() - 1);
+        ImGui::SliderInt("Frames ago", &selected, 0, frames.size() - 1);
+
+        const Frame &frame = frames[frames.size() - 1 - selected];
+        ImGui::Text("Frame %llu: %.2f ms", frame.index, frame.duration);
+
+        ShowTimeline(frame);
+
+        ImGui::Separator();
+        ShowAverages(frames);
+
+        ImGui::End();
+    }
+}
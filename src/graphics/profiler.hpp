@@ -0,0 +1,105 @@
+#pragma once
+
+// Standard Headers
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * CPU and GPU timings of the last frames, to find out where the frame time goes.
+ *
+ * A CpuScope measures the time until the end of its scope. Scopes nest and work on every thread:
+ * the samples of worker threads (generation, the climate simulation) are added to the frame in which they ended.
+ *
+ * A GpuScope measures the GPU time of the GL commands in its scope with a GL_TIME_ELAPSED query.
+ * Only one of those queries can be active at a time, so GPU scopes can not nest; the FrameGraph wraps every pass in one.
+ * The results are read FRAMES_IN_FLIGHT frames later, and only when they are available, so the CPU never waits for the GPU.
+ * A result that is still not available then is dropped.
+ *
+ * nextFrame() ends a frame, Scene::update() calls it. The last HISTORY_SIZE frames are kept,
+ * for ShowWindow() and the exporters.
+ */
+namespace Profiler
+{
+    static const unsigned int FRAMES_IN_FLIGHT = 4, HISTORY_SIZE = 300;
+
+    struct Sample {
+        // Interned, stays valid
+        const char *name;
+        unsigned int thread, depth;
+
+        // In milliseconds since the start of the program
+        double start, duration;
+    };
+
+    struct GpuSample {
+        const char *name;
+        double duration;
+    };
+
+    struct Frame {
+        unsigned long long index;
+        double start, duration;
+
+        // In the order in which the scopes ended
+        std::vector<Sample> cpu;
+
+        // In the order of the passes, empty until the queries of the frame are read
+        std::vector<GpuSample> gpu;
+    };
+
+    class CpuScope
+    {
+      public:
+        // name has to outlive the profiler (a string literal), use the std::string version otherwise
+        CpuScope(const char *name);
+        CpuScope(const std::string &name);
+        ~CpuScope();
+
+      private:
+        const char *name;
+        double start;
+    };
+
+    class GpuScope
+    {
+      public:
+        GpuScope(const char *name);
+        GpuScope(const std::string &name);
+        ~GpuScope();
+    };
+
+    void nextFrame();
+
+    /**
+     * The frames that ended, oldest first.
+     */
+    const std::deque<Frame> & getHistory();
+
+    /**
+     * The newest frame whose GPU queries have been read, NULL before the first one.
+     */
+    const Frame * lastCompleteFrame();
+
+    /**
+     * Name of the thread that ran a sample, the render thread is the one that calls nextFrame().
+     */
+    std::string threadName(unsigned int thread);
+
+    /**
+     * One row per sample: frame, thread, name, depth, start and duration in milliseconds, the start relative to the frame.
+     * GPU samples are on the thread "gpu", laid out after each other from the start of the frame.
+     */
+    void exportCsv(const std::string &path);
+
+    /**
+     * The history as a trace for chrome://tracing or Perfetto. The GPU passes are laid out after each other
+     * from the start of their frame, a GL_TIME_ELAPSED query has no start time.
+     */
+    void exportChromeTrace(const std::string &path);
+
+    /**
+     * Frame times, averages per scope and a timeline of a frame.
+     */
+    void ShowWindow(bool* p_open);
+}
@@ -0,0 +1,137 @@
+#include "render_queue.hpp"
+
+// Standard Headers
+#include <algorithm>
+
+// Local Headers
+#include "geometry/mesh.hpp"
+#include "graphics/gl_state.hpp"
+#include "graphics/gl_error.hpp"
+
+void PassState::apply() const
+{
+    GLState::setBlend(blend);
+    if (blend) GLState::setBlendFunc(blendSrc, blendDst);
+
+    GLState::setDepthTest(depthTest);
+    GLState::setDepthMask(depthMask);
+    GLState::setDepthFunc(depthFunc);
+}
+
+TextureSet::TextureSet() : id([] {
+    static GLuint nextId = 0;
+    return nextId++;
+}()) {}
+
+void TextureSet::set(GLuint unit, GLenum target, GLuint textureId)
+{
+    for (Binding &binding : bindings)
+    {
+        if (binding.unit != unit || binding.target != target) continue;
+        binding.id = textureId;
+        return;
+    }
+    bindings.push_back({unit, target, textureId});
+}
+
+void TextureSet::bind() const
+{
+    for (const Binding &binding : bindings)
+        GLState::bindTexture(binding.unit, binding.target, binding.id);
+}
+
+uint64_t RenderQueue::makeKey(unsigned int pass, GLuint program, GLuint textureSet, GLuint vertexArray, float depth, bool blended)
+{
+    const uint64_t DEPTH_MAX = (1 << 24) - 1;
+
+    uint64_t p = pass & 0xff, s = program & 0x3ff, t = textureSet & 0x3ff, v = vertexArray & 0xfff;
+    uint64_t d = (uint64_t) (std::min(std::max(depth, 0.f), 1.f) * DEPTH_MAX);
+
+    if (blended)
+        return p << 56 | (DEPTH_MAX - d) << 32 | s << 22 | t << 12 | v;
+
+    return p << 56 | s << 46 | t << 36 | v << 24 | d;
+}
+
+void RenderQueue::submit(uint64_t key, DrawItem item)
+{
+    keys.emplace_back(key, items.size());
+    items.push_back(std::move(item));
+}
+
+static bool isBatchable(const DrawItem &item)
+{
+    return !item.draw && item.mesh && item.shader && item.shader->multiDraw;
+}
+
+static bool sameBatch(const DrawItem &a, const DrawItem &b)
+{
+    return isBatchable(b) && a.shader == b.shader && a.state == b.state && a.textures == b.textures
+        && a.mesh->vertBuffer == b.mesh->vertBuffer && a.mesh->mode == b.mesh->mode;
+}
+
+void RenderQueue::buildBatches()
+{
+    batches.clear();
+    multiDraw.clear();
+
+    for (unsigned int begin = 0, end; begin < keys.size(); begin = end)
+    {
+        const DrawItem &first = items[keys[begin].second];
+        end = begin + 1;
+        if (!isBatchable(first)) continue;
+
+        // Their shader has no model uniform, so even a single mesh goes through the multi draw
+        multiDraw.add(*first.mesh, first.model);
+        for (; end < keys.size() && sameBatch(first, items[keys[end].second]); end++)
+        {
+            const DrawItem &item = items[keys[end].second];
+            multiDraw.add(*item.mesh, item.model);
+        }
+        batches.push_back({begin, end, multiDraw.endRun()});
+    }
+    multiDraw.upload();
+}
+
+void RenderQueue::flush()
+{
+    // Equal keys keep the order in which they were submitted
+    std::sort(keys.begin(), keys.end());
+
+    buildBatches();
+    auto batch = batches.begin();
+
+    for (unsigned int i = 0; i < keys.size(); i++)
+    {
+        const DrawItem &item = items[keys[i].second];
+
+        if (item.state) item.state->apply();
+        if (item.shader) item.shader->enable();
+        if (item.textures) item.textures->bind();
+
+        if (batch != batches.end() && batch->begin == i)
+        {
+            multiDraw.draw(batch->run);
+            i = batch->end - 1;
+            batch++;
+            continue;
+        }
+
+        if (item.draw)
+        {
+            item.draw();
+            check_gl_error();
+            continue;
+        }
+
+        if (item.shader)
+            glUniformMatrix4fv(item.shader->uniform(Uniform::model), 1, GL_FALSE, glm::value_ptr(item.model));
+
+        if (item.mesh) item.mesh->render();
+        check_gl_error();
+    }
+
+    // clear() keeps the capacity, so the next frame does not allocate
+    keys.clear();
+    items.clear();
+}
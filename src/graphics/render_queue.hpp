@@ -0,0 +1,121 @@
+#pragma once
+
+// System Headers
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+
+// Standard Headers
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Local Headers
+#include "graphics/shader.hpp"
+#include "graphics/texture.hpp"
+#include "graphics/texture_array.hpp"
+#include "graphics/cube_map.hpp"
+#include "graphics/multi_draw.hpp"
+
+class Mesh;
+
+/**
+ * Blend and depth state of a pass, applied through GLState before each of its draws.
+ */
+struct PassState {
+    bool blend = false;
+    GLenum blendSrc = GL_SRC_ALPHA, blendDst = GL_ONE_MINUS_SRC_ALPHA;
+
+    bool depthTest = true, depthMask = true;
+    GLenum depthFunc = GL_LESS;
+
+    void apply() const;
+};
+
+/**
+ * The textures a pass samples from, bound to their units before each of its draws.
+ * Renderers fill it in every frame, the bindings that did not change are elided by GLState.
+ */
+class TextureSet {
+    private:
+        struct Binding {
+            GLuint unit;
+            GLenum target;
+            GLuint id;
+        };
+        std::vector<Binding> bindings;
+
+        void set(GLuint unit, GLenum target, GLuint id);
+
+    public:
+        // Used in the sort key, so draws with the same textures end up next to each other
+        const GLuint id;
+
+        TextureSet();
+
+        void set(GLuint unit, const Texture & texture) { set(unit, GL_TEXTURE_2D, texture.id); }
+        void set(GLuint unit, const TextureArray & texture) { set(unit, GL_TEXTURE_2D_ARRAY, texture.id); }
+        void set(GLuint unit, const CubeMap & texture) { set(unit, GL_TEXTURE_CUBE_MAP, texture.id); }
+
+        void bind() const;
+};
+
+/**
+ * One draw in the queue, either a mesh with a model matrix or a custom draw function.
+ */
+struct DrawItem {
+    Shader * shader = nullptr;
+    const PassState * state = nullptr;
+    const TextureSet * textures = nullptr;
+
+    Mesh * mesh = nullptr;
+    glm::mat4 model = glm::mat4(1.f);
+
+    // For draws that are not a mesh of a renderable, like the skybox or instanced clouds
+    std::function<void()> draw;
+};
+
+/**
+ * Passes submit their draws with a 64 bit sort key, flush() sorts them and issues them in key order.
+ *
+ * Opaque key, most significant bits first:
+ *   pass (8) | program (10) | texture set (10) | vertex array (12) | depth, front to back (24)
+ *
+ * Blended key, the depth order comes before the state:
+ *   pass (8) | depth, back to front (24) | program (10) | texture set (10) | vertex array (12)
+ *
+ * The pass keeps the order of the renderers, within a pass the draws that share state end up next to each other,
+ * so the program, texture, vertex array, blend and depth changes between them are elided by GLState.
+ *
+ * Consecutive meshes with the same program, state, textures and VertBuffer are drawn with one multi draw
+ * when their shader reads the model from the PerDraw block (see MultiDraw).
+ */
+class RenderQueue {
+    private:
+        std::vector<DrawItem> items;
+        std::vector<std::pair<uint64_t, unsigned int>> keys;
+
+        // Ranges of keys [begin, end) that are drawn as one run of the multi draw
+        struct Batch {
+            unsigned int begin, end, run;
+        };
+        std::vector<Batch> batches;
+        MultiDraw multiDraw;
+
+        void buildBatches();
+
+    public:
+        /**
+         * depth: distance to the camera divided by the far plane, clamped to [0, 1].
+         */
+        static uint64_t makeKey(unsigned int pass, GLuint program, GLuint textureSet, GLuint vertexArray, float depth, bool blended);
+
+        void submit(uint64_t key, DrawItem item);
+
+        /**
+         * Issues and removes all submitted draws, in key order.
+         */
+        void flush();
+
+        bool empty() const { return items.empty(); }
+};
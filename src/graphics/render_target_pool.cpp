@@ -0,0 +1,52 @@
+#include "render_target_pool.hpp"
+
+// Standard Headers
+#include <algorithm>
+#include <string>
+
+bool RenderTargetDesc::operator==(const RenderTargetDesc &other) const
+{
+    return width == other.width && height == other.height && colorFormat == other.colorFormat && depth == other.depth;
+}
+
+FrameBuffer * RenderTargetPool::acquire(const RenderTargetDesc &desc)
+{
+    for (Entry &entry : entries)
+    {
+        if (entry.inUse || !(entry.desc == desc)) continue;
+
+        entry.inUse = true;
+        entry.lastUsed = frame;
+        return entry.target.get();
+    }
+
+    FrameBuffer * target = new FrameBuffer(desc.width, desc.height);
+    if (desc.colorFormat) target->addColorTexture(desc.colorFormat, GL_LINEAR, GL_LINEAR);
+    if (desc.depth) target->addDepthTexture(GL_LINEAR, GL_LINEAR);
+
+    entries.push_back({desc, std::unique_ptr<FrameBuffer>(target), true, frame});
+    return target;
+}
+
+void RenderTargetPool::release(FrameBuffer * target)
+{
+    for (Entry &entry : entries)
+    {
+        if (entry.target.get() != target) continue;
+
+        if (!entry.inUse) throw "RenderTargetPool: FrameBuffer " + std::to_string(target->id) + " was released twice";
+        entry.inUse = false;
+        entry.lastUsed = frame;
+        return;
+    }
+    throw "RenderTargetPool: FrameBuffer " + std::to_string(target->id) + " is not from this pool";
+}
+
+void RenderTargetPool::nextFrame()
+{
+    frame++;
+
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [this](const Entry &entry) {
+        return !entry.inUse && frame - entry.lastUsed > MAX_UNUSED_FRAMES;
+    }), entries.end());
+}
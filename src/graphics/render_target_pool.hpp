@@ -0,0 +1,65 @@
+#pragma once
+
+// Standard Headers
+#include <memory>
+#include <vector>
+
+// Local Headers
+#include "graphics/frame_buffer.hpp"
+
+/**
+ * Size and attachments of a pooled FrameBuffer.
+ */
+struct RenderTargetDesc {
+    GLuint width, height;
+
+    // Format of the color texture, for example GL_RGB, or 0 for no color
+    GLuint colorFormat;
+
+    // Adds a depth texture
+    bool depth;
+
+    bool operator==(const RenderTargetDesc &other) const;
+};
+
+/**
+ * Hands out FrameBuffers by size and format, so passes do not create their own.
+ *
+ * A transient target is acquired when a pass starts writing it and released after the last pass read it.
+ * A released target is given to the next acquire with the same description, in the same frame too,
+ * so targets with lifetimes that do not overlap share memory (ping-pong buffers fall out of this).
+ * A target that is never released belongs to its pass, for results that are kept over multiple frames.
+ *
+ * Targets that were not used for MAX_UNUSED_FRAMES are deleted by nextFrame(). After a resize
+ * the old sizes disappear that way, while going back and forth between sizes does not create new ones.
+ */
+class RenderTargetPool
+{
+  public:
+    static const unsigned int MAX_UNUSED_FRAMES = 60;
+
+    FrameBuffer * acquire(const RenderTargetDesc &desc);
+
+    /**
+     * The contents of the target are undefined after this, the next acquire can return it.
+     */
+    void release(FrameBuffer * target);
+
+    /**
+     * Call once per frame, before the first acquire.
+     */
+    void nextFrame();
+
+    unsigned int size() const { return entries.size(); }
+
+  private:
+    struct Entry {
+        RenderTargetDesc desc;
+        std::unique_ptr<FrameBuffer> target;
+        bool inUse;
+        unsigned int lastUsed;
+    };
+
+    std::vector<Entry> entries;
+    unsigned int frame = 0;
+};
@@ -0,0 +1,117 @@
+#include "render_view.hpp"
+
+// Standard Headers
+#include <cmath>
+
+// Local Headers
+#include "common/universe.hpp"
+
+/**
+ * World box of a model space box, without transforming its 8 corners (Arvo).
+ */
+static bounding_box transformBox(const bounding_box & box, const glm::mat4 & model)
+{
+    glm::vec3 center = (box.min + box.max) * .5f, extent = (box.max - box.min) * .5f;
+
+    glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.f));
+    glm::vec3 worldExtent(0.f);
+    for (int axis = 0; axis < 3; axis++)
+        worldExtent += glm::abs(glm::vec3(model[axis])) * extent[axis];
+
+    return {worldCenter + worldExtent, worldCenter - worldExtent};
+}
+
+void RenderView::List::clear()
+{
+    // clear() keeps the capacity, so after the first frame this does not allocate
+    items.clear();
+    bounds.clear();
+    bounded.clear();
+}
+
+void RenderView::build(const Universe & universe)
+{
+    if (hierarchyChanged(universe)) flatten(universe);
+
+    for (unsigned int i = 0; i < nodes.size(); i++)
+        if (nodes[i].renderable->update_model()) transforms.setLocal(i, nodes[i].renderable->get_last_model());
+
+    // New nodes always get their world matrix, so this also covers a new hierarchy
+    if (transforms.update()) transformVersion++;
+
+    renderables.clear();
+    suns.clear();
+
+    for (unsigned int i = 0; i < nodes.size(); i++)
+    {
+        Renderable * renderable = nodes[i].renderable;
+        List & list = *nodes[i].list;
+
+        glm::mat4 model = transforms.getWorld(i);
+        list.items.push_back({renderable, model, i});
+
+        // The box of every item only covers its own meshes, children have their own item
+        bool bounded = renderable->has_bounding_box();
+        list.bounds.push_back(bounded ? transformBox(renderable->get_local_bounding_box(), model) : bounding_box());
+        list.bounded.push_back(bounded);
+    }
+
+    renderables.bvh.build(renderables.bounds, renderables.bounded);
+    suns.bvh.build(suns.bounds, suns.bounded);
+}
+
+bool RenderView::hierarchyChanged(const Universe & universe) const
+{
+    if (nodes.empty() || hierarchyVersion != Renderable::get_hierarchy_version()) return true;
+
+    const std::vector<Renderable *> & planets = universe.getRenderables();
+    const std::vector<Sun *> & universeSuns = universe.getSuns();
+    if (roots.size() != planets.size() + universeSuns.size()) return true;
+
+    for (unsigned int i = 0; i < planets.size(); i++)
+        if (roots[i] != planets[i]) return true;
+    for (unsigned int i = 0; i < universeSuns.size(); i++)
+        if (roots[planets.size() + i] != universeSuns[i]) return true;
+    return false;
+}
+
+void RenderView::flatten(const Universe & universe)
+{
+    nodes.clear();
+    roots.clear();
+    transforms.clear();
+    hierarchyVersion = Renderable::get_hierarchy_version();
+
+    for (Renderable * renderable : universe.getRenderables())
+    {
+        roots.push_back(renderable);
+        addNode(renderable, -1, renderables);
+    }
+
+    for (Sun * sun : universe.getSuns())
+    {
+        roots.push_back(sun);
+        addNode(sun, -1, suns);
+    }
+}
+
+void RenderView::addNode(Renderable * renderable, int parent, List & list)
+{
+    // Depth first, so every parent comes before its children
+    renderable->update_model();
+    unsigned int node = transforms.addNode(parent, renderable->get_last_model());
+    nodes.push_back({renderable, &list});
+
+    for (Renderable * child : renderable->get_children())
+        addNode(child, node, list);
+}
+
+void RenderView::cull(const std::vector<RenderItem> & items, const Frustum & frustum, std::vector<unsigned int> & visible) const
+{
+    if (&items == &renderables.items)
+        renderables.bvh.cull(frustum, visible);
+    else if (&items == &suns.items)
+        suns.bvh.cull(frustum, visible);
+    else
+        throw "RenderView::cull() only knows the lists of this RenderView";
+}
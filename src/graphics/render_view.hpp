@@ -0,0 +1,89 @@
+#pragma once
+
+// Standard Headers
+#include <vector>
+#include <glm/mat4x4.hpp>
+
+// Local Headers
+#include "graphics/renderable.hpp"
+#include "graphics/frustum.hpp"
+#include "graphics/bounding_volume_hierarchy.hpp"
+#include "graphics/transform_system.hpp"
+
+class Universe;
+
+/**
+ * A renderable together with its world transform for the current frame.
+ */
+struct RenderItem {
+    Renderable * renderable;
+    glm::mat4 model;
+
+    // Node in the TransformSystem of the RenderView
+    unsigned int transform;
+};
+
+/**
+ * Read-only snapshot of everything that is drawn in a frame.
+ *
+ * Scene::draw() builds it once, before the first pass. The hierarchy of the Universe is flattened into
+ * the node array of a TransformSystem, and only flattened again when a child is added or the roots change.
+ * Every frame the dirty renderables update their local matrix, the world matrices are updated in one
+ * linear sweep, and every pass walks the same flat lists by reference.
+ *
+ * The world boxes of the items go into a BoundingVolumeHierarchy per list, so every pass can cull
+ * the list with its own camera.
+ */
+class RenderView {
+    private:
+        struct List {
+            std::vector<RenderItem> items;
+            std::vector<bounding_box> bounds;
+            std::vector<bool> bounded;
+            BoundingVolumeHierarchy bvh;
+
+            void clear();
+        };
+        List renderables, suns;
+
+        // Renderable and list of every node of transforms
+        struct Node {
+            Renderable * renderable;
+            List * list;
+        };
+        std::vector<Node> nodes;
+        TransformSystem transforms;
+
+        // What the nodes were flattened from
+        std::vector<Renderable *> roots;
+        unsigned int hierarchyVersion = 0;
+
+        unsigned int transformVersion = 0;
+
+        bool hierarchyChanged(const Universe & universe) const;
+        void flatten(const Universe & universe);
+        void addNode(Renderable * renderable, int parent, List & list);
+
+    public:
+        void build(const Universe & universe);
+
+        /**
+         * Planets and their children, parents always come before their children.
+         */
+        const std::vector<RenderItem> & getRenderables() const { return renderables.items; }
+
+        const std::vector<RenderItem> & getSuns() const { return suns.items; }
+
+        const TransformSystem & getTransforms() const { return transforms; }
+
+        /**
+         * Changes every frame in which a world matrix changed or the hierarchy was flattened again.
+         */
+        unsigned int getTransformVersion() const { return transformVersion; }
+
+        /**
+         * Replaces the contents of visible with the indices in items of the ones that intersect the frustum.
+         * items has to be getRenderables() or getSuns().
+         */
+        void cull(const std::vector<RenderItem> & items, const Frustum & frustum, std::vector<unsigned int> & visible) const;
+};
@@ -15,6 +15,10 @@ void Renderable::update_bounding_box() {
     }
 }
 
+bool Renderable::has_bounding_box() const {
+    return glm::all(glm::lessThanEqual(_model_bbox.min, _model_bbox.max));
+}
+
 orientation_state Renderable::get_current_state() {
     orientation_state state;
     state.position = _origin;
@@ -14,6 +14,8 @@
 
 #include "utils/obb.hpp"
 
+class Mesh;
+
 class Renderable {
 private:
     glm::mat4 _model_matrix;
@@ -28,6 +30,12 @@ protected:
     bounding_box _model_bbox;
 
     std::vector<Renderable *> _children;
+
+    // Call after changing _origin, _scale, _direction, _rotation or _to_parent_matrix directly
+    void mark_dirty() { _dirty = true; }
+private:
+    bool _dirty = true;
+    inline static unsigned int _hierarchy_version = 0;
 public:
     Renderable(const glm::vec3 & model_direction): 
         _model_matrix(1.f),
@@ -45,49 +53,76 @@ public:
     virtual void upload() = 0; 
     virtual void render(RenderType type) = 0;
 
-    virtual void set_parent_matrix(glm::mat4 transformation) { _to_parent_matrix = transformation; }
-    virtual glm::mat4& get_to_parent_matrix() { return _to_parent_matrix; }
+    /**
+     * The mesh that render(type) draws, nullptr when there is nothing to draw for that type.
+     * Used by the render queue to sort draws on their vertex array.
+     */
+    virtual Mesh * get_mesh(RenderType type) { return nullptr; }
+
+    virtual void set_parent_matrix(glm::mat4 transformation) { _to_parent_matrix = transformation; mark_dirty(); }
+    virtual const glm::mat4& get_to_parent_matrix() { return _to_parent_matrix; }
 
     const glm::mat4& get_last_model() { return _model_matrix; }
 
-    virtual void set_position(const glm::vec3 & pos) { _origin = pos; }
+    virtual void set_position(const glm::vec3 & pos) { _origin = pos; mark_dirty(); }
     virtual const glm::vec3& get_position() { return _origin; }
 
     glm::quat calculate_rotation(const glm::vec3 & direction);
 
-    void update_model() {
+    /**
+     * Recomputes the model matrix if the position, direction, scale or parent matrix changed since the last call.
+     * Returns whether it was recomputed.
+     */
+    bool update_model() {
+        if (!_dirty) return false;
+
         glm::mat4 translate_matrix = glm::translate( glm::mat4(1.0f), _origin);
         glm::mat4 rotation_matrix = glm::toMat4(calculate_rotation(_direction));
         glm::mat4 scale_matrix = glm::scale(glm::mat4(1.0f), _scale);
        
         _model_matrix = _to_parent_matrix * translate_matrix * rotation_matrix * scale_matrix;
+        _dirty = false;
+        return true;
     }
 
     virtual void set_direction(glm::vec3 direction) { 
         _direction = direction;
         _rotation = calculate_rotation(direction);
+        mark_dirty();
     }
     
     virtual void set_rotation(glm::quat rotation) { 
         _rotation = rotation; 
         _direction = glm::rotate(_rotation, _model_direction);
+        mark_dirty();
     }
-    virtual glm::quat& get_rotation() { return _rotation; }
+    virtual const glm::quat& get_rotation() { return _rotation; }
 
     virtual glm::vec3 get_scale() { return _scale; }
-    virtual void set_scale(glm::vec3 scale) {  _scale = scale; }
+    virtual void set_scale(glm::vec3 scale) {  _scale = scale; mark_dirty(); }
 
     virtual void update_bounding_box();
 
+    /**
+     * Box around the meshes in model space, used for frustum culling.
+     * Subclasses set it when their meshes are uploaded, until then has_bounding_box() is false and the renderable is never culled.
+     */
+    const bounding_box & get_local_bounding_box() const { return _model_bbox; }
+    bool has_bounding_box() const;
+
     orientation_state get_current_state();
     bounding_box get_model_bounding_box();
     OBB generate_bounding_box();
 
     // Scene Graph stuff
-    std::vector<Renderable *> get_children() { return _children; }
+    const std::vector<Renderable *> & get_children() const { return _children; }
     void add_child(Renderable * child) { 
         _children.push_back(child);
+        _hierarchy_version++;
     }
+
+    // Changes every time a child is added anywhere, so flattened copies of the hierarchy know when to rebuild
+    static unsigned int get_hierarchy_version() { return _hierarchy_version; }
 };
 
 // class DummyRenderable: public Renderable {
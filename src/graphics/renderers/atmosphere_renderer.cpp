@@ -1,5 +1,8 @@
 #include "atmosphere_renderer.hpp"
 
+// Standard Headers
+#include <algorithm>
+
 #include "scene.hpp"
 #include "graphics/window_size.hpp"
 #include "graphics/camera.hpp"
@@ -7,61 +10,79 @@
 #include "utils/resource_manager.hpp"
 
 #include "graphics/gl_error.hpp"
-#include "render_type.hpp"
 
 AtmosphereRenderer::AtmosphereRenderer() {
-    Shader shader = ResourceManager::LoadShader("atmosphere.vert", "atmosphere.frag", "atmosphere");
+    shader = ResourceManager::LoadShader("atmosphere.vert", "atmosphere.frag", "atmosphere");
 
     check_gl_error();
 }
 
-void AtmosphereRenderer::render(double dt) {
-    Shader shader = ResourceManager::GetShader("atmosphere");
-    shader.enable();
-    check_gl_error();
-
-    glDepthMask(false);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    check_gl_error();
-
-    applyUniforms(shader);
-    check_gl_error();
-
-    Universe universe = Globals::scene->getUniverse();
+AtmosphereRenderer::~AtmosphereRenderer() {
+    delete target;
+}
 
-    draw_objects(universe.getRenderables(), glm::mat4(1.f), shader, RenderType::Atmosphere, true);
+void AtmosphereRenderer::render(double dt) {
+    FrameBuffer * sceneBuffer = Globals::scene->frameGraph.getTarget("scene");
+
+    // The scene buffer is a different pooled target after a resize
+    if (!target || target->colorTexture != sceneBuffer->colorTexture)
+    {
+        delete target;
+        target = new FrameBuffer(sceneBuffer->width, sceneBuffer->height);
+        target->attachColorTexture(sceneBuffer->colorTexture);
+    }
+
+    // Farthest first, so every atmosphere is blended over the ones behind it
+    const glm::vec3 & cameraPosition = camera->getPosition();
+    planets = Globals::scene->getUniverse().getPlanets();
+    std::sort(planets.begin(), planets.end(), [&](Planet * a, Planet * b) {
+        return glm::distance(a->get_position(), cameraPosition) > glm::distance(b->get_position(), cameraPosition);
+    });
+
+    target->bind();
+    shader->enable();
+
+    GLState::setDepthTest(false);
+    GLState::setBlend(true);
+    GLState::setBlendFunc(GL_ONE, GL_SRC1_COLOR);
+
+    sceneBuffer->depthTexture->bind(0);
+    glUniform1i(shader->uniform(Uniform::sceneDepth), 0);
+
+    glm::mat4 inverseViewProjection = glm::inverse(camera->combined);
+    glUniformMatrix4fv(shader->uniform(Uniform::inverseViewProjection), 1, GL_FALSE, &inverseViewProjection[0][0]);
+
+    for (Planet * planet : planets)
+    {
+        if (!planet->atmosphere) continue;
+
+        applyUniforms(*shader, *planet);
+        Mesh::getQuad()->render();
+    }
     check_gl_error();
 
-    glDepthMask(true);
-    check_gl_error();
+    GLState::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::setDepthTest(true);
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    target->unbind();
 }
 
-void AtmosphereRenderer::applyUniforms(Shader & shader) {
-    
-    glm::vec3 cameraPosition = camera->getState().position;
-
-    // glUniform3fv(shader.uniform("camPos"), 1, glm::value_ptr(camera.getPosition()));
-
-    // float planetRadius = 150;
-    // float atmosphereRadius = 200;
-
-    // glm::mat4 atmoModel = glm::mat4(1.0f);
-    // glm::vec3 cP = glm::normalize(cameraPosition) * planetRadius;
-
-    // float lon = glm::degrees(atan2(cP.x, cP.z) + 180.f); // earth.longitude(cP.x, cP.z);
-    // float lat = glm::degrees(acos(cP.y / planetRadius));
+void AtmosphereRenderer::applyUniforms(Shader & shader, Planet & planet) {
+    const AtmosphereLUT & lut = *planet.atmosphere;
+    const AtmosphereProfile & profile = lut.profile;
 
-    // atmoModel = glm::rotate(atmoModel, glm::radians(-(lon + 90)), mu::Y);
-    // atmoModel = glm::rotate(atmoModel, glm::radians(lat), mu::X);
+    lut.bind(1, 2);
+    glUniform1i(shader.uniform(Uniform::transmittanceLUT), 1);
+    glUniform1i(shader.uniform(Uniform::scatteringLUT), 2);
 
-    // glm::vec3 atmosphereSunDir = camera->sunDir;
-    // atmosphereSunDir = glm::rotate(atmosphereSunDir, glm::radians((lon + 90)), mu::Y);
-    // atmosphereSunDir = glm::rotate(atmosphereSunDir, glm::radians(-lat), mu::X);
+    glm::vec3 center = planet.get_position();
+    glm::vec3 sunDirection = glm::normalize(Globals::scene->getUniverse().getSuns().front()->get_position() - center);
 
-    // glUniformMatrix4fv(shader.uniform("atmoModel"), 1, GL_FALSE, &atmoModel[0][0]);
-    // glUniform1f(shader.uniform("camDist"), glm::length(cameraPosition) - atmosphereRadius);
-    glUniform3fv(shader.uniform("sunDir"), 1, glm::value_ptr(camera->sunDir));
+    glUniform3fv(shader.uniform(Uniform::planetCenter), 1, &center[0]);
+    glUniform3fv(shader.uniform(Uniform::sunDirection), 1, &sunDirection[0]);
+    glUniform3fv(shader.uniform(Uniform::rayleighScattering), 1, &profile.rayleighScattering[0]);
+    glUniform1f(shader.uniform(Uniform::planetRadius), lut.planetRadius);
+    glUniform1f(shader.uniform(Uniform::atmosphereRadius), lut.atmosphereRadius());
+    glUniform1f(shader.uniform(Uniform::mieG), profile.mieG);
+    glUniform1f(shader.uniform(Uniform::sunIntensity), profile.sunIntensity);
 }
@@ -4,14 +4,29 @@
 #include "renderer.hpp"
 #include "common/planet.hpp"
 #include "graphics/shader.hpp"
+#include "graphics/frame_buffer.hpp"
 
-#include "graphics/texture.hpp"
-#include "graphics/texture_array.hpp"
-
+/**
+ * Atmospheric scattering of every planet, in one full-screen pass per planet over the scene.
+ *
+ * atmosphere.frag finds the part of each view ray that is inside the atmosphere, ends it at the depth of
+ * the scene, and reads the light scattered along it and the transmittance from the AtmosphereLUT of the planet.
+ * The scene is dimmed by the transmittance and the scattered light is added with dual source blending,
+ * so the pass draws straight into the color texture of the scene, without a copy.
+ *
+ * Drawn after the opaque scene and before post processing, the depth texture of the scene is read,
+ * so it is not attached to the target of this pass.
+ */
 class AtmosphereRenderer: public Renderer {
     private:
-        void applyUniforms(Shader & shader);
+        // Only the color texture of the scene buffer
+        FrameBuffer * target = nullptr;
+
+        std::vector<Planet *> planets;
+
+        void applyUniforms(Shader & shader, Planet & planet);
     public: 
         AtmosphereRenderer();
+        ~AtmosphereRenderer();
         void render(double dt);
 };
@@ -4,110 +4,139 @@
 // Local Headers
 #include "graphics/vert_buffer.hpp"
 #include "utils/math_utils.h"
-#include "utils/math/interpolation.h"
 #include "scene.hpp"
+#include "graphics/profiler.hpp"
 
-const int nrOfSpawnpoints = 30, particlesPerOffset = 6;
+const int nrOfSpawnpoints = 30, particlesPerOffset = 6, maxClouds = 40;
+
+// Every cloud gets the instances of the largest cloud, clouds.vert discards the ones it does not use
+const int particlesPerCloud = nrOfSpawnpoints * particlesPerOffset;
+
+static Cloud spawnCloud(const Planet * planet, float time)
+{
+    for (int attempt = 0; attempt < 8; attempt++)
+    {
+        // Uniform over the sphere, in the lon/lat of the planet
+        float lon = mu::random(360), lat = glm::degrees(glm::acos(1 - 2 * mu::random()));
+
+        float density = planet->climate ? planet->climate->cloudDensity(lon, lat) : .5f;
+        if (mu::random() >= density) continue;
+
+        glm::vec2 wind = planet->climate ? planet->climate->wind(lon, lat) : glm::vec2(.7f, .4f);
+
+        // clouds.vert rotates around Y by its lon, which runs the other way (lon 0 is the planets lon 270)
+        return {
+            270 - lon, lat,
+            -wind.x, wind.y,
+            time,
+            time + mu::random(30, 60), // time to live
+            mu::randomInt(3, 3 + (int) (27 * density)) // nr of particles
+        };
+    }
+
+    // Clear sky, try again later
+    return {0, 0, 0, 0, time, time + mu::random(5, 15), 0};
+}
 
 CloudRenderer::CloudRenderer():   
     quad(new Mesh("cloud_quad", 4, 6, Mesh::getQuad()->attributes))
 {
-    ResourceManager::LoadShader("clouds.vert", "clouds.frag", "clouds");
+    shader = ResourceManager::LoadShader("clouds.vert", "clouds.frag", "clouds");
     noiseTex = ResourceManager::LoadTexture("textures/noise.dds", "noise");
 
+    state.blend = true;
+    state.depthMask = false;
+
     quad->vertices = Mesh::getQuad()->vertices;
     quad->indices = Mesh::getQuad()->indices;
     VertBuffer::uploadSingleMesh(quad);
 
-    VertAttributes verts;
-    unsigned int spawnpoint_offset = verts.add({"SPAWNPOINT", 3});
-
-    const Universe & universe = Globals::scene->getUniverse();
-    const std::vector<Planet * > & planets = universe.getPlanets();
-
-    VertData spawnpoints(verts, std::vector<u_char>(nrOfSpawnpoints * 4 * 3 * planets.size()));
-    // for (int p = 0; p < planets.size(); p++) {
-        int p = 0;
-        for (int i = 0; i < nrOfSpawnpoints; i++) {
-            glm::vec3 spawn = glm::vec3(mu::random() - .5, (mu::random() - .5) * .3, mu::random() - .5) * vec3(1 + i * .2) * vec3(110.);
-            // spawn += planets[p]->get_position();
-            spawnpoints.set(spawn, p * nrOfSpawnpoints + i, spawnpoint_offset);
-        }
-    // }
-
-    quad->vertBuffer->uploadPerInstanceData(spawnpoints, particlesPerOffset);
+    for (int i = 0; i < nrOfSpawnpoints; i++)
+        spawnPoints.push_back(glm::vec3(mu::random() - .5, (mu::random() - .5) * .3, mu::random() - .5) * vec3(1 + i * .2) * vec3(110.));
 }
 
-void CloudRenderer::render(double realtimeDT) {
-    const Universe & universe = Globals::scene->getUniverse();
-    const std::vector<Planet * > & planets = universe.getPlanets();
+CloudRenderer::PlanetClouds &CloudRenderer::getClouds(const Planet * planet, float time)
+{
+    VertAttributes attrs;
+    unsigned int path_offset = attrs.add({"CLOUD_PATH", 4});
+    unsigned int life_offset = attrs.add({"CLOUD_LIFE", 3});
 
-    for (Planet * planet : universe.getPlanets()) {
-        // The dt above is real time. The universe dt is the simulations. 
-        render(planet, universe.getTime(), universe.getDeltaTime());
+    auto it = planetClouds.find(planet);
+    bool created = it == planetClouds.end();
+    if (created)
+    {
+        it = planetClouds.emplace(planet, PlanetClouds()).first;
+        for (int i = 0; i < maxClouds; i++) it->second.clouds.push_back(spawnCloud(planet, time));
     }
-}
-
-void CloudRenderer::render(Planet * planet, double time, float deltaTime)
-{
-    float planetRadius = 150;
+    PlanetClouds &planet_clouds = it->second;
 
-    while (clouds.size() < 40)
-        clouds.push_back({
-            mu::random(360), // lon
-            mu::random(mu::random() > .5 ? 40. : 0., mu::random() > .5 ? 120. : 180.), // lat
-            mu::random(.7, 1.3), // speed
-            0,
-            mu::random(30, 60), // time to live
-            mu::randomInt(3, 30) // nr of particles
-        });
+    bool changed = created;
+    for (Cloud &cloud : planet_clouds.clouds)
+    {
+        if (time < cloud.despawnTime) continue;
 
-    Shader shader = ResourceManager::GetShader("clouds");
-    shader.enable();
+        cloud = spawnCloud(planet, time);
+        changed = true;
+    }
+    if (!changed) return planet_clouds;
 
-    glUniform1f(shader.uniform("time"), time);
-   
-    noiseTex->bind(0);
-    glUniform1i(shader.uniform("noiseTex"), 0);
+    VertData data(attrs, std::vector<u_char>(maxClouds * attrs.getVertSize()));
+    for (int i = 0; i < maxClouds; i++)
+    {
+        const Cloud &cloud = planet_clouds.clouds[i];
+        data.set(glm::vec4(cloud.lon, cloud.lat, cloud.lonSpeed, cloud.latSpeed), i, path_offset);
+        data.set(glm::vec3(cloud.spawnTime, cloud.despawnTime, cloud.spawnPoints * particlesPerOffset), i, life_offset);
+    }
 
-    glDepthMask(false);
+    if (created) planet_clouds.instanceData = quad->vertBuffer->uploadPerInstanceData(data, particlesPerCloud);
+    else quad->vertBuffer->updatePerInstanceData(planet_clouds.instanceData, data);
 
-    for (int i = clouds.size() - 1; i >= 0; i--)
-    {
-        auto &cloud = clouds[i];
+    return planet_clouds;
+}
 
-        cloud.timeSinceSpawn += deltaTime;
-        cloud.timeToDespawn -= deltaTime;
+void CloudRenderer::render(double realtimeDT) {
+    Profiler::CpuScope profile("CloudRenderer");
 
-        if (cloud.timeToDespawn <= 0) clouds.erase(clouds.begin() + i);
+    const Universe & universe = Globals::scene->getUniverse();
+    const RenderView & view = Globals::scene->getRenderView();
 
-        cloud.lon += .7 * deltaTime * cloud.speed;
-        cloud.lat += .4 * deltaTime * cloud.speed;
-        
-        glm::mat4 transformFromCenter = rotate(glm::mat4(1.f), glm::radians(cloud.lon), mu::Y);
-        transformFromCenter = rotate(transformFromCenter, glm::radians(cloud.lat), mu::X);
-        transformFromCenter = translate(transformFromCenter, vec3(0, planet->config.radius + planet->config.cloudHeight, 0));
+    // One batch for all planets, indexed by transform slot
+    view.getTransforms().computeMVPs(camera->combined, mvps);
 
-        glm::mat4 transformFromCenterInverse = glm::inverse(transformFromCenter);
+    // Shared by all planets, only this renderer uses the program
+    shader->enable();
 
-        CameraState state = camera->getState();
-        glm::vec3 up = transformFromCenterInverse * vec4(state.up, 0);
-        glm::vec3 right = transformFromCenterInverse * vec4(state.right, 0);
- 
-        glm::mat4 transform = camera->combined * planet->get_last_model() * transformFromCenter;
+    textures.set(0, *noiseTex);
+    glUniform1i(shader->uniform(Uniform::noiseTex), 0);
+    glUniform3fv(shader->uniform(Uniform::spawnPoints), nrOfSpawnpoints, glm::value_ptr(spawnPoints[0]));
 
-        float light = 0;
-        light += max(0.f, 1 - Interpolation::circleIn(min(1., cloud.lat / 30.)));
-        light += max(0.f, 1 - Interpolation::circleIn(min(1., (180 - cloud.lat) / 30.)));
+    const CameraState & cameraState = camera->getState();
+    glUniform3f(shader->uniform(Uniform::up), cameraState.up.x, cameraState.up.y, cameraState.up.z);
+    glUniform3f(shader->uniform(Uniform::right), cameraState.right.x, cameraState.right.y, cameraState.right.z);
 
-        light += min(1.f, max(0.0f, dot(rotate(vec3(0, 0, 1), cloud.lon * mu::DEGREES_TO_RAD, mu::Y), camera->sunDir) + .8f));
+    for (const RenderItem & item : view.getRenderables()) {
+        const Planet * planet = dynamic_cast<const Planet *>(item.renderable);
+        if (!planet) continue;
 
-        glUniformMatrix4fv(shader.uniform("mvp"), 1, GL_FALSE, glm::value_ptr(transform));
-        glUniform3f(shader.uniform("up"), up.x, up.y, up.z);
-        glUniform3f(shader.uniform("right"), right.x, right.y, right.z);
-        glUniform1f(shader.uniform("cloudOpacity"), Interpolation::circleIn(max(0.f, min(cloud.timeToDespawn, cloud.timeSinceSpawn)) / 20.));
-        glUniform1f(shader.uniform("light"), light);
-        quad->renderInstances(cloud.spawnPoints * particlesPerOffset);
+        // The dt above is real time, the clouds move with the simulation time.
+        render(planet, mvps[item.transform], universe.getTime());
     }
-    glDepthMask(true);
+}
+
+void CloudRenderer::render(const Planet * planet, const glm::mat4 & mvp, float time)
+{
+    GLuint instanceData = getClouds(planet, time).instanceData;
+    float cloudDistance = planet->config.radius + planet->config.cloudHeight;
+
+    DrawItem draw;
+    draw.shader = shader.get();
+    draw.state = &state;
+    draw.textures = &textures;
+    draw.draw = [this, mvp, cloudDistance, instanceData]() {
+        glUniformMatrix4fv(shader->uniform(Uniform::mvp), 1, GL_FALSE, glm::value_ptr(mvp));
+        glUniform1f(shader->uniform(Uniform::cloudDistance), cloudDistance);
+        quad->vertBuffer->usePerInstanceData(instanceData, particlesPerCloud);
+        quad->renderInstances(maxClouds * particlesPerCloud);
+    };
+    Globals::scene->renderQueue.submit(sortKey(quad->vertBuffer->getVaoId(), 0.f), std::move(draw));
 }
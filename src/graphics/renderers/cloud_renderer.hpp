@@ -1,5 +1,8 @@
 #pragma once
 
+// Standard Headers
+#include <map>
+
 // Local Headers
 #include "common/planet.hpp"
 #include "graphics/camera.hpp"
@@ -7,12 +10,23 @@
 #include "graphics/renderers/renderer.hpp"
 #include "utils/resource_manager.hpp"
 
+/**
+ * A cloud only changes when it spawns, its position and fading are derived from
+ * the universe time in clouds.vert.
+ */
 struct Cloud
 {
-    float lon, lat, speed, timeSinceSpawn, timeToDespawn;
-    int spawnPoints;
+    float lon, lat; // at spawnTime, in degrees
+    float lonSpeed, latSpeed; // wind at the spawn position, in degrees per second
+    float spawnTime, despawnTime;
+    int spawnPoints; // 0 for an empty slot
 };
 
+/**
+ * The clouds of a planet live in a per instance buffer of the quad mesh, so a planet is 1 instanced draw.
+ * Expired clouds are replaced in place, the buffer is only uploaded again when that happens.
+ * New clouds spawn where the Climate of the planet has clouds, and drift with its wind.
+ */
 class CloudRenderer: public Renderer
 {
   public:
@@ -21,10 +35,19 @@ class CloudRenderer: public Renderer
     void render(double dt);
 
   private:
+    struct PlanetClouds
+    {
+        std::vector<Cloud> clouds;
+        GLuint instanceData;
+    };
+
     SharedMesh quad;
     SharedTexture noiseTex;
-    std::vector<Cloud> clouds;
+    std::vector<glm::vec3> spawnPoints;
+    std::map<const Planet *, PlanetClouds> planetClouds;
+    std::vector<glm::mat4> mvps;
 
-    void render(Planet * plt, double time, float deltaTime);
-};
+    PlanetClouds &getClouds(const Planet * planet, float time);
 
+    void render(const Planet * planet, const glm::mat4 & mvp, float time);
+};
@@ -6,32 +6,28 @@
 
 #include "graphics/gl_error.hpp"
 #include "render_type.hpp"
+#include "graphics/profiler.hpp"
 
 PathRenderer::PathRenderer() {
-    Shader shader = ResourceManager::LoadShader("path.vert", "path.frag", "path");
+    shader = ResourceManager::LoadShader("path.vert", "path.frag", "path");
     check_gl_error();
+
+    // The orbits are in world space, far outside the box of their planet
+    culling = false;
 }
 
 void PathRenderer::render(double dt) {
-    Shader shader = ResourceManager::GetShader("path");
-    shader.enable();
-    check_gl_error();
+    Profiler::CpuScope profile("PathRenderer");
 
-    glDisable(GL_BLEND);
+    shader->enable();
     check_gl_error();
 
-    applyUniforms(shader);
+    applyUniforms(*shader);
     check_gl_error();
 
-    Universe universe = Globals::scene->getUniverse();
-    const std::vector<Renderable *> & renderables = universe.getRenderables();
-
-    for(auto t=renderables.begin(); t!=renderables.end(); ++t) {
-        (*t)->render(RenderType::Path);
-        check_gl_error();
-    }
+    submit_objects(Globals::scene->getRenderView().getRenderables(), RenderType::Path);
 }
 
 void PathRenderer::applyUniforms(Shader & shader) {
-    glUniformMatrix4fv( shader.uniform("MVP"), 1, GL_FALSE, glm::value_ptr(camera->combined)); // projection matrix
+    // Paths are in world space, path.vert only needs viewProjection from the PerView block
 }
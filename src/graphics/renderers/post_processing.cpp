@@ -4,25 +4,8 @@
 #include "graphics/window_size.hpp"
 // #include "graphics/camera.hpp"
 // #include "common/universe.hpp"
+#include "graphics/vert_buffer.hpp"
 #include "utils/resource_manager.hpp"
-#include <glm/gtx/intersect.hpp>
-
-PostProcessing::PostProcessing()  {
-    Shader shader = ResourceManager::LoadShader("post_processing.vert", "post_processing.frag", "post_processing");
-    Shader flare = ResourceManager::LoadShader("post_processing.vert", "flare.frag", "flare");
-
-    flareTextures = ResourceManager::LoadTextureArray({
-        "textures/sun/flare1.dds",
-        "textures/sun/flare0.dds",
-        "textures/sun/flare3.dds",
-        "textures/sun/flare4.dds",
-        "textures/sun/flare5.dds"
-    }, "flares");
-
-
-    check_gl_error();
-}
-
 
 const LensFlare PostProcessing::flares[] = {
     {4, vec4(1), 1, 1, false},
@@ -63,113 +46,168 @@ const LensFlare PostProcessing::flares[] = {
     {0, vec4(.2, 1, .5, 1), .008, 1.81, false},
 };
 
-void PostProcessing::render(double dt) {
-
-    Shader shader = ResourceManager::GetShader("post_processing");
-    shader.enable();
+PostProcessing::PostProcessing():
+    flareQuad(new Mesh("flare_quad", 4, 6, Mesh::getQuad()->attributes))
+{
+    shader = ResourceManager::LoadShader("post_processing.vert", "post_processing.frag", "post_processing");
+    SharedShader zoomBlurShader = ResourceManager::LoadShader("post_processing.vert", "zoom_blur.frag", "zoom_blur");
+    flareShader = ResourceManager::LoadShader("flare.vert", "flare.frag", "flare");
 
-    glDisable(GL_DEPTH_TEST);
+    flareTextures = ResourceManager::LoadTextureArray({
+        "textures/sun/flare1.dds",
+        "textures/sun/flare0.dds",
+        "textures/sun/flare3.dds",
+        "textures/sun/flare4.dds",
+        "textures/sun/flare5.dds"
+    }, "flares");
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    flareQuad->vertices = Mesh::getQuad()->vertices;
+    flareQuad->indices = Mesh::getQuad()->indices;
+    VertBuffer::uploadSingleMesh(flareQuad);
 
-    applyUniforms(shader);
-    Mesh::getQuad()->render();
+    VertAttributes attrs;
+    unsigned int color_offset = attrs.add({"FLARE_COLOR", 4});
+    unsigned int shape_offset = attrs.add({"FLARE_SHAPE", 4});
 
-    Shader flareShader = ResourceManager::GetShader("flare");
-    flareShader.enable();
+    int nrOfFlares = sizeof(flares) / sizeof(flares[0]);
+    VertData data(attrs, std::vector<u_char>(nrOfFlares * attrs.getVertSize()));
+    for (int i = 0; i < nrOfFlares; i++)
+    {
+        const LensFlare &flare = flares[i];
+        data.set(flare.color, i, color_offset);
+        data.set(glm::vec4(flare.texture, flare.scale, flare.dist, flare.rotate ? 1 : 0), i, shape_offset);
+    }
+    flareQuad->vertBuffer->uploadPerInstanceData(data);
+
+    // The blur hides detail anyway, so it runs at a quarter of the pixels
+    PostEffect zoomBlur;
+    zoomBlur.name = "zoom_blur";
+    zoomBlur.shader = zoomBlurShader;
+    zoomBlur.resolutionScale = .5;
+    zoomBlur.isActive = [] { return Globals::scene->planetCamera.zoomVelocity / 2. > .05; };
+    zoomBlur.applyUniforms = [] (Shader & shader) {
+        glUniform1f(shader.uniform(Uniform::zoomEffect), Globals::scene->planetCamera.zoomVelocity / 2.);
+    };
+    addEffect(zoomBlur);
+
+    // Chromatic aberration, fog and vignette
+    PostEffect composite;
+    composite.name = "composite";
+    composite.shader = shader;
+    composite.isActive = [] { return true; };
+    composite.applyUniforms = [] (Shader & shader) {
+        glUniform1f(shader.uniform(Uniform::zoom), Globals::scene->planetCamera.atmosphereTilt);
+    };
+    addEffect(composite);
 
-    glBlendFunc(GL_ONE, GL_ONE);
+    check_gl_error();
+}
 
-    renderFlares(flareShader);
+void PostProcessing::addEffect(const PostEffect & effect, int position)
+{
+    if (position < 0) effects.push_back(effect);
+    else effects.insert(effects.begin() + position, effect);
+}
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_DEPTH_TEST);
+void PostProcessing::setEnabled(const std::string & name, bool enabled)
+{
+    for (PostEffect & effect : effects)
+        if (effect.name == name) effect.enabled = enabled;
 }
 
-void PostProcessing::renderFlares(Shader & shader) {
+void PostProcessing::render(double dt) {
 
-    float lensFlareA = 1;
+    GLState::setDepthTest(false);
+    GLState::setBlend(false);
 
-    int steps = 50;
+    std::vector<PostEffect *> active;
+    for (PostEffect & effect : effects)
+        if (effect.enabled && effect.isActive()) active.push_back(&effect);
 
-    const Universe & universe = Globals::scene->getUniverse();
-    const glm::vec3 & cameraPosition = camera->getPosition();
+    RenderTargetPool & pool = Globals::scene->renderTargets;
+    FrameBuffer * sceneBuffer = Globals::scene->frameGraph.getTarget("scene");
+    SharedTexture input = sceneBuffer->colorTexture;
 
-    for (int i = 0; i < steps; i++)
-    {
-        vec3 sd = glm::rotate(camera->sunDir, (float) (.05 * (((float) i - steps * .5) / steps)), mu::Y);
-        vec3 sunPos = cameraPosition + sd;
+    // Released as soon as the next effect has read it, so effect i + 2 can write to it again
+    FrameBuffer * previous = NULL;
 
-        bool inViewport = false;
-        camera->project(sunPos, inViewport);
-        bool intersectsPlanet = false;
+    for (unsigned int i = 0; i < active.size(); i++)
+    {
+        PostEffect & effect = *active[i];
+        FrameBuffer * target = NULL;
+        if (i + 1 < active.size())
+        {
+            target = pool.acquire({
+                std::max(1u, (GLuint) (WindowSize::widthPixels * effect.resolutionScale)),
+                std::max(1u, (GLuint) (WindowSize::heightPixels * effect.resolutionScale)),
+                GL_RGB, false
+            });
+            target->bind();
+        }
 
-        for (Planet * planet : universe.getPlanets()) {
+        effect.shader->enable();
+        Shader & shader = *effect.shader;
 
-            float distance;
-            if (glm::intersectRaySphere(cameraPosition, sd, planet->get_position(), pow(planet->config.radius, 2), distance))
-            {
-                intersectsPlanet  = true;
-                break;
-            }
-        }
+        glUniformMatrix4fv(shader.uniform(Uniform::MVP), 1, GL_FALSE, &(glm::mat4(1.f))[0][0]);
+        glUniform2f(shader.uniform(Uniform::resolution),
+            target ? target->width : WindowSize::widthPixels, target ? target->height : WindowSize::heightPixels);
 
-        if (!inViewport || intersectsPlanet)
-            lensFlareA -= 1.0 / steps;
-     }
+        input->bind(0);
+        glUniform1i(shader.uniform(Uniform::scene), 0);
 
-    lensFlareA = pow(lensFlareA, 2.);
-    lensFlareA = lensFlareAlpha = (lensFlareA + lensFlareAlpha) * .5;
-    
-    vec2 screenSunPos = camera->project(cameraPosition + camera->sunDir);
+        sceneBuffer->depthTexture->bind(1);
+        glUniform1i(shader.uniform(Uniform::sceneDepth), 1);
 
-    lensFlareA *= 1.4 - length(screenSunPos);
-    lensFlareA *= .45;
+        effect.applyUniforms(shader);
+        Mesh::getQuad()->render();
 
-    flareTextures->bind(0);
-    glUniform1i(shader.uniform("textures"), 0);
+        if (previous) pool.release(previous);
+        previous = target;
 
-    glm::mat4 correctScale = scale(mat4(1), vec3(((float) WindowSize::height / WindowSize::width), 1, 1));
+        if (!target) continue;
+        target->unbind();
+        input = target->colorTexture;
+    }
+    if (previous) pool.release(previous);
 
-    for (auto &flare : flares)
-    {
-        mat4 mvp = translate(scale(mat4(1), vec3(flare.scale)), vec3(screenSunPos * flare.dist / flare.scale, 1)) * correctScale;
+    flareShader->enable();
 
-        if (flare.rotate)
-        {
-            mvp = glm::rotate(
-                mvp,
-                (float) -atan2(screenSunPos.x, screenSunPos.y) + mu::PI * -1.25f,
-                mu::Z
-            );
-        }
-	    
-        glUniformMatrix4fv(shader.uniform("MVP"), 1, GL_FALSE, &(mvp)[0][0]);
-        glUniform1i(shader.uniform("layer"), flare.texture);
-        glUniform4f(shader.uniform("flareColor"), flare.color.r, flare.color.g, flare.color.b, flare.color.a * lensFlareA);
+    GLState::setBlend(true);
+    GLState::setBlendFunc(GL_ONE, GL_ONE);
 
-        Mesh::getQuad()->render();
-    }
-    glEnable(GL_DEPTH_TEST);
+    renderFlares(*flareShader);
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::setDepthTest(true);
 }
 
-void PostProcessing::applyUniforms(Shader & shader) {
-    
-    glUniformMatrix4fv(shader.uniform("MVP"), 1, GL_FALSE, &(glm::mat4(1.f))[0][0]);
-    glUniform1f(shader.uniform("zoomEffect"), Globals::scene->planetCamera.zoomVelocity / 2.);
-    glUniform1f(shader.uniform("zoom"), Globals::scene->planetCamera.atmosphereTilt);
-    glUniform2f(shader.uniform("resolution"), WindowSize::widthPixels, WindowSize::heightPixels);
-
-    // Bind results from other buffers
-    if (KeyInput::pressed(GLFW_KEY_Y)) {
-        Globals::scene->shadow_renderer->sunDepthTexture->bind(0);
-    } else {
-        Globals::scene->sceneBuffer->colorTexture->bind(0);
-    }
-    glUniform1i(shader.uniform("scene"), 0);
+void PostProcessing::renderFlares(Shader & shader) {
+
+    const glm::vec3 & cameraPosition = camera->getPosition();
+
+    // Sun behind the camera, its projection would end up mirrored on the screen
+    glm::vec4 clipSunPos = camera->combined * glm::vec4(cameraPosition + camera->sunDir, 1);
+    if (clipSunPos.w <= 0) return;
+
+    vec2 screenSunPos = vec2(clipSunPos) / clipSunPos.w;
+
+    // Everything that is not closer than the front of the sun lets the sun through
+    Sun * sun = Globals::scene->getUniverse().getSuns().front();
+    glm::vec4 clipSunFront = camera->combined * glm::vec4(sun->get_position() - camera->sunDir * sun->shape.radius, 1);
+    float sunDepth = clipSunFront.w > 0 ? glm::clamp(clipSunFront.z / clipSunFront.w * .5f + .5f, 0.f, 1.f) : 0.f;
+
+    float intensity = max(0.f, 1.4f - length(screenSunPos)) * .45f;
+
+    flareTextures->bind(0);
+    glUniform1i(shader.uniform(Uniform::textures), 0);
+
+    Globals::scene->frameGraph.getTarget("scene")->depthTexture->bind(1);
+    glUniform1i(shader.uniform(Uniform::sceneDepth), 1);
+
+    glUniform2f(shader.uniform(Uniform::sunScreenPosition), screenSunPos.x, screenSunPos.y);
+    glUniform1f(shader.uniform(Uniform::sunDepth), sunDepth);
+    glUniform1f(shader.uniform(Uniform::flareIntensity), intensity);
+    glUniform1f(shader.uniform(Uniform::flareRotation), -atan2(screenSunPos.x, screenSunPos.y) + mu::PI * -1.25f);
 
-    Globals::scene->sceneBuffer->depthTexture->bind(1);
-    glUniform1i(shader.uniform("sceneDepth"), 1);
+    flareQuad->renderInstances(sizeof(flares) / sizeof(flares[0]));
 }
@@ -1,9 +1,16 @@
 #pragma once
 
+// Standard Headers
+#include <functional>
+#include <string>
+#include <vector>
+
 // Local Headers
 #include "graphics/shader.hpp"
 #include "graphics/renderers/renderer.hpp"
 #include "graphics/texture_array.hpp"
+#include "graphics/frame_buffer.hpp"
+#include "geometry/mesh.hpp"
 
 struct LensFlare
 {
@@ -13,15 +20,49 @@ struct LensFlare
     bool rotate;
 };
 
+/**
+ * One step of the post chain. It draws a full screen quad that reads the output
+ * of the previous step (sampler 'scene' on unit 0) into a target of resolutionScale times the window size,
+ * taken from the RenderTargetPool of the Scene.
+ * The last active step draws to the screen.
+ */
+struct PostEffect
+{
+    std::string name;
+    SharedShader shader;
+    float resolutionScale = 1;
+    bool enabled = true;
+
+    // Skips the effect for this frame when it returns false, for example a blur that would not be visible
+    std::function<bool()> isActive;
+
+    // Sets the uniforms of the effect, units 0 and 1 are taken by the input and the scene depth
+    std::function<void(Shader &)> applyUniforms;
+};
+
+/**
+ * All lens flares are 1 instanced draw of a quad, the flares are a static per instance buffer.
+ * flare.vert samples the scene depth around the sun to see how much of it is visible,
+ * so the cost does not depend on the number of planets.
+ */
 class PostProcessing: public Renderer {
     private:
         static const LensFlare flares[];
+        SharedShader flareShader;
         SharedTexArray flareTextures;
-        float lensFlareAlpha = 0;
+        SharedMesh flareQuad;
+
+        std::vector<PostEffect> effects;
 
         void renderFlares(Shader & shader);
-        void applyUniforms(Shader & shader);
     public: 
         PostProcessing();
         void render(double dt);
+
+        /**
+         * Inserts an effect before position, or at the end of the chain when position is -1.
+         */
+        void addEffect(const PostEffect & effect, int position = -1);
+
+        void setEnabled(const std::string & name, bool enabled);
 };
@@ -1,3 +1,3 @@
 #pragma once
 
-enum RenderType { Atmosphere, Terrain, Water, Path };
\ No newline at end of file
+enum RenderType { Terrain, Water, Path };
\ No newline at end of file
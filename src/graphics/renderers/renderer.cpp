@@ -1,40 +1,42 @@
 #include "renderer.hpp"
 
 #include "scene.hpp"
+#include "graphics/vert_buffer.hpp"
 
 Renderer::Renderer(): camera(&Globals::scene->camera) {}
 Renderer::Renderer(Camera * camera): camera(camera) {}
 
-void Renderer::draw_objects(const std::vector<Renderable *> & renderables, glm::mat4 parent_model, Shader & shader, RenderType type, bool update_model) {
-    if (renderables.size() == 0) return;
+uint64_t Renderer::sortKey(GLuint vertexArray, float depth) const {
+    return RenderQueue::makeKey(pass, shader->program_id, textures.id, vertexArray, depth, state.blend);
+}
 
+void Renderer::submit_objects(const std::vector<RenderItem> & items, RenderType type) {
     if (!camera) throw "No Camera"; 
 
-    for(auto t=renderables.begin(); t!=renderables.end(); ++t) {
-        
-        check_gl_error();
-        // default_phong_uniforms();
-
-        if (update_model) (*t)->update_model();
-
-        glm::mat4 model = parent_model * (*t)->get_last_model();
+    RenderQueue & queue = Globals::scene->renderQueue;
 
-        // glUniformMatrix4fv( shader.uniform("model"), 1, GL_FALSE, glm::value_ptr(model)); // model matrix
-        glUniformMatrix4fv( shader.uniform("MVP"), 1, GL_FALSE, glm::value_ptr(camera->combined * model)); // projection matrix
-        
-        if (shadows) {
-            mat4 shadowMatrix = ShadowRenderer::BIAS_MATRIX * Globals::scene->shadow_renderer->camera->combined * model; 
-            glUniformMatrix4fv(shader.uniform("shadowMatrix"), 1, GL_FALSE, &((shadowMatrix)[0][0]));
-        }
-
-        check_gl_error();
-        (*t)->render(type);
-        check_gl_error();
-
-        // std::cout << "has children " << (*t)->get_children().size() << std::endl;
-        draw_objects((*t)->get_children(), model, shader, type, update_model);
+    if (culling)
+        Globals::scene->getRenderView().cull(items, Frustum(camera->combined), visible);
+    else
+    {
+        visible.resize(items.size());
+        for (unsigned int i = 0; i < items.size(); i++) visible[i] = i;
+    }
 
-        // After all their children have been updated
-        (*t)->update_bounding_box();
+    // The models were updated once for the whole frame by RenderView::build()
+    for (unsigned int i : visible) {
+        const RenderItem & item = items[i];
+        Mesh * mesh = item.renderable->get_mesh(type);
+        if (!mesh) continue;
+
+        DrawItem draw;
+        draw.shader = shader.get();
+        draw.state = &state;
+        draw.textures = &textures;
+        draw.mesh = mesh;
+        draw.model = item.model;
+
+        float depth = glm::distance(camera->getPosition(), glm::vec3(item.model[3])) / camera->last_z_far;
+        queue.submit(sortKey(mesh->vertBuffer ? mesh->vertBuffer->getVaoId() : 0, depth), std::move(draw));
     }
 }
@@ -8,14 +8,35 @@
 #include "graphics/renderable.hpp"
 #include "graphics/shader.hpp"
 #include "graphics/camera.hpp"
+#include "graphics/render_view.hpp"
+#include "graphics/render_queue.hpp"
 
 class Renderer {
     protected:
-        bool shadows = false;
-        virtual void draw_objects(const std::vector<Renderable *> & renderables, glm::mat4 parent_model, Shader & shader, RenderType type, bool update_model); 
+        SharedShader shader;
+        PassState state;
+        TextureSet textures;
+
+        // Skip the items outside the frustum of the camera, off for passes whose meshes are not inside the bounds of their renderable
+        bool culling = true;
+
+        /**
+         * Submits the meshes of the items to the render queue of the scene, with the shader, state and textures of this pass.
+         * They are drawn when the queue is flushed.
+         * items has to be a list of the RenderView of the scene, it is culled with the frustum of the camera.
+         */
+        virtual void submit_objects(const std::vector<RenderItem> & items, RenderType type);
+
+        uint64_t sortKey(GLuint vertexArray, float depth) const;
+    private:
+        std::vector<unsigned int> visible;
     public:
         Renderer();
         Renderer(Camera * camera);
         Camera * camera;
+
+        // Order of the pass in the render queue
+        unsigned int pass = 0;
+
         virtual void render(double dt) = 0;
 };
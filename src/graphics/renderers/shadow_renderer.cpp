@@ -6,55 +6,142 @@
 // Local headers
 #include "scene.hpp"
 #include "utils/resource_manager.hpp"
+#include "graphics/vert_buffer.hpp"
 
-ShadowRenderer::ShadowRenderer(): Renderer(new Camera(2048, 2048)), buffer(2048, 2048)
+ShadowRenderer::ShadowRenderer(): Renderer(nullptr), buffer(SIZE, SIZE)
 {
-    // camera = new Camera(150, 150, 90);
-//    Renderer::camera = shadowCamera;
-    camera->mode = ProjectionType::Orthographic;
-    
-    buffer.addDepthTexture(GL_LINEAR, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-    sunDepthTexture = buffer.depthTexture;
-
-    Shader shader = ResourceManager::LoadShader("shadow.vert", "empty.frag", "shadow");
+    for (unsigned int i = 0; i < NR_OF_CASCADES; i++)
+    {
+        cameras.emplace_back(SIZE, SIZE);
+        cameras.back().mode = ProjectionType::Orthographic;
+    }
+    camera = &cameras.front();
+
+    sunDepthTexture = SharedTexArray(new TextureArray());
+    sunDepthTexture->generateDepth(SIZE, SIZE, NR_OF_CASCADES);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, sunDepthTexture->id);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    shader = ResourceManager::LoadShader("shadow.vert", "empty.frag", "shadow");
 }
 
 void ShadowRenderer::render(double dt) {
-    Shader shader = ResourceManager::GetShader("shadow");
-    shader.enable();
+    const Camera & view = Globals::scene->getCamera();
+    const RenderView & renderView = Globals::scene->getRenderView();
+
+    calculateSplits(view);
+
+    shader->enable();
+
+    bool drawn = false;
+    float near = view.last_z_near;
+    for (unsigned int i = 0; i < NR_OF_CASCADES; i++)
+    {
+        Camera fitted = cameras[i];
+        fitCascade(fitted, view, near, splits[i]);
+        near = splits[i];
+
+        // Shadows do not animate, so time is not an input
+        PassInputs inputs = {fitted.combined, renderView.getTransformVersion(), VertBuffer::getUploadVersion(), 0.};
+        if (!cascadeCaches[i].needsUpdate(inputs)) continue;
+
+        cameras[i] = fitted;
+        camera = &cameras[i];
+        drawn = true;
+
+        buffer.bindDepthLayer(*sunDepthTexture, i);
+        GLState::setDepthMask(true); // glClear respects the depth mask
+        glClear(GL_DEPTH_BUFFER_BIT);
+
+        Globals::scene->bindView(*camera);
+
+        // Culled with the camera of this cascade
+        submit_objects(renderView.getRenderables(), RenderType::Terrain);
 
-    begin();
+        // Every cascade has its own layer, so it is drawn right away
+        Globals::scene->renderQueue.flush();
+    }
+
+    if (drawn) buffer.unbind();
+}
+
+void ShadowRenderer::calculateSplits(const Camera & view)
+{
+    float near = view.last_z_near, far = min(view.last_z_far, MAX_DISTANCE);
+
+    for (unsigned int i = 1; i <= NR_OF_CASCADES; i++)
+    {
+        float part = (float) i / NR_OF_CASCADES;
 
-    glDisable(GL_BLEND);
-    Universe universe = Globals::scene->getUniverse();
-    draw_objects(universe.getRenderables(), glm::mat4(1.f), shader, RenderType::Terrain, true);
-    glDisable(GL_BLEND);
+        float logarithmic = near * pow(far / near, part);
+        float uniform = near + (far - near) * part;
 
-    buffer.unbind();
+        splits[i - 1] = mix(uniform, logarithmic, SPLIT_LAMBDA);
+    }
 }
 
-void ShadowRenderer::begin()
+void ShadowRenderer::fitCascade(Camera & cascadeCamera, const Camera & view, float near, float far)
 {
-    const Universe & universe = Globals::scene->getUniverse();
+    const CameraState & state = view.getState();
 
-    float z_far = 0.1, z_near = std::numeric_limits<float>::max();
+    // Corners of the slice of the view frustum between near and far
+    float tanHalfFov = tan(radians(view.fov) * .5f), aspect = view.viewportWidth / view.viewportHeight;
 
-    for (Planet * planet : universe.getPlanets()) {
-        float dist = glm::distance(planet->get_position(), camera->getPosition());
+    vec3 corners[8];
+    vec3 center(0.f);
+    for (int i = 0; i < 8; i++)
+    {
+        float depth = i < 4 ? near : far;
+        float x = (i & 1 ? 1.f : -1.f) * depth * tanHalfFov * aspect;
+        float y = (i & 2 ? 1.f : -1.f) * depth * tanHalfFov;
 
-        z_far = max(z_far, dist + planet->config.radius * 2);
-        z_near = min(z_near, dist - planet->config.radius * 2);
+        corners[i] = state.position + state.direction * depth + state.right * x + state.up * y;
+        center += corners[i] / 8.f;
     }
 
-    camera->lookAt(glm::vec3(0.f));
+    // The radius only depends on the shape of the slice, rounding it up keeps it from changing with rounding errors
+    float radius = 0.f;
+    for (const vec3 & corner : corners) radius = max(radius, distance(corner, center));
+    radius = ceil(radius * 16.f) / 16.f;
+
+    // The sun is a point light, but over the size of the system around the camera its direction is constant
+    const Universe & universe = Globals::scene->getUniverse();
+    vec3 sunPosition = universe.getSuns().front()->get_position();
+    vec3 direction = normalize(state.position - sunPosition);
+
+    vec3 up = abs(direction.y) > .99f ? mu::X : mu::Y;
+    vec3 right = normalize(cross(direction, up));
+    up = cross(right, direction);
+
+    // Snap the center to whole texels in light space
+    float texel = radius * 2.f / SIZE;
+    vec3 light(dot(center, right), dot(center, up), dot(center, direction));
+    light.x = floor(light.x / texel) * texel;
+    light.y = floor(light.y / texel) * texel;
+
+    // Planets between the sun and the slice cast shadows into it, so the camera starts before the first of them
+    float casters = 0.f;
+    for (Planet * planet : universe.getPlanets())
+    {
+        vec3 position = planet->get_position();
+        float planetRadius = planet->config.radius * 2;
+
+        if (abs(dot(position, right) - light.x) > radius + planetRadius) continue;
+        if (abs(dot(position, up) - light.y) > radius + planetRadius) continue;
+
+        float before = light.z - dot(position, direction) + planetRadius - radius;
+        casters = max(casters, before);
+    }
 
-    CameraState state = camera->getState();
-    state.position = universe.getSuns().front()->get_position();
-    camera->moveTo(state, false);
+    cascadeCamera.viewportWidth = cascadeCamera.viewportHeight = radius * 2.f;
 
-    camera->calculate(z_near, z_far);
+    CameraState cascadeState = cascadeCamera.getState();
+    cascadeState.position = right * light.x + up * light.y + direction * (light.z - radius - casters);
+    cascadeState.direction = direction;
+    cascadeState.up = up;
+    cascadeState.right = right;
+    cascadeCamera.moveTo(cascadeState, false);
 
-    buffer.bind();
-    glClear(GL_DEPTH_BUFFER_BIT);
+    cascadeCamera.calculate(0.f, radius * 2.f + casters);
 }
@@ -1,11 +1,30 @@
 #pragma once
 
-#include "graphics/texture.hpp"
+// Standard Headers
+#include <vector>
+
+#include "graphics/texture_array.hpp"
 #include "utils/math_utils.h"
 #include "graphics/frame_buffer.hpp"
+#include "graphics/pass_cache.hpp"
 #include "graphics/camera.hpp"
 #include "graphics/renderers/renderer.hpp"
 
+/**
+ * Cascaded shadow maps of the sun.
+ *
+ * The frustum of the main camera is split in NR_OF_CASCADES slices along its view direction
+ * (a mix of logarithmic and uniform splits), every slice gets its own orthographic camera and layer
+ * in a depth texture array. Near the camera a texel covers a few world units instead of spreading
+ * one map over the whole system, and the cascades together fill as many texels as the old single map.
+ *
+ * Every cascade is a bounding sphere of its slice, with the radius rounded up and the center snapped
+ * to whole texels in light space: when the camera moves or turns the shadow maps only move by whole texels,
+ * so the edges of the shadows do not shimmer.
+ *
+ * A cascade is only drawn again when its camera, the bodies or the meshes changed, and the far cascades
+ * are amortized over several frames (see cascadeCaches).
+ */
 class ShadowRenderer: public Renderer
 {
   public:
@@ -17,13 +36,42 @@ class ShadowRenderer: public Renderer
         0.5, 0.5, 0.5, 1.0
     );
 
-    SharedTexture sunDepthTexture;
+    // Has to match the size of shadowMatrices in the PerView block of the shaders
+    static const unsigned int NR_OF_CASCADES = 4;
+    static const unsigned int SIZE = 1024;
+
+    // Nothing beyond this distance from the camera gets a shadow
+    inline static const float MAX_DISTANCE = 1500.f;
+
+    // 0 is uniform splits, 1 is logarithmic splits
+    inline static const float SPLIT_LAMBDA = .8f;
+
+    // One layer per cascade
+    SharedTexArray sunDepthTexture;
+
+    // The intervals can be changed to amortize the cascades over more or fewer frames
+    PassCache cascadeCaches[NR_OF_CASCADES] = {PassCache(1), PassCache(1), PassCache(2), PassCache(4)};
 
     ShadowRenderer();
 
     void render(double dt);
 
+    /**
+     * World space to the shadow map of a cascade, bias included.
+     * This is the camera the layer was last drawn with, so a skipped cascade is still sampled correctly.
+     */
+    glm::mat4 getShadowMatrix(unsigned int cascade) const { return BIAS_MATRIX * cameras[cascade].combined; }
+
+    /**
+     * Distance along the view direction of the main camera where each cascade ends.
+     */
+    const glm::vec4 & getCascadeSplits() const { return splits; }
+
   private:
     FrameBuffer buffer;
-    void begin();
-};
\ No newline at end of file
+    std::vector<Camera> cameras;
+    glm::vec4 splits;
+
+    void calculateSplits(const Camera & view);
+    void fitCascade(Camera & cascadeCamera, const Camera & view, float near, float far);
+};
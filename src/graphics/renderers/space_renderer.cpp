@@ -8,6 +8,7 @@
 #include "common/planet.hpp"
 #include "scene.hpp"
 #include "utils/resource_manager.hpp"
+#include "graphics/profiler.hpp"
 
 float skyboxVertices[] = {
     // positions          
@@ -56,7 +57,7 @@ float skyboxVertices[] = {
 
 SpaceRenderer::SpaceRenderer()
 {
-    Shader space_cube = ResourceManager::LoadShader("space_box.vert", "space_box.frag", "space_cube");
+    shader = ResourceManager::LoadShader("space_box.vert", "space_box.frag", "space_cube");
 
     cubeMap = ResourceManager::LoadCubeMap({
         "textures/space_cubemap/right.dds",
@@ -70,41 +71,42 @@ SpaceRenderer::SpaceRenderer()
     // skybox VAO
     glGenVertexArrays(1, &skyboxVAO);
     glGenBuffers(1, &skyboxVBO);
-    glBindVertexArray(skyboxVAO);
+    GLState::bindVertexArray(skyboxVAO);
     glBindBuffer(GL_ARRAY_BUFFER, skyboxVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    
+
+    // The box is drawn at the far plane, where the depth buffer is still 1
+    state.blend = true;
+    state.depthFunc = GL_LEQUAL;
 }
 
 void SpaceRenderer::render(double dt)
 {
-    Shader shader = ResourceManager::GetShader("space_cube");
+    Profiler::CpuScope profile("SpaceRenderer");
 
-    // glDisable(GL_BLEND);
-    glDepthFunc(GL_LEQUAL);
-    
-    shader.enable();
+    shader->enable();
 
-    glUniform1f(shader.uniform("atmosphere"), Globals::scene->planetCamera.atmosphereTilt);
+    glUniform1f(shader->uniform(Uniform::atmosphere), Globals::scene->planetCamera.atmosphereTilt);
 
     float daylight = 1.f - pow(((glm::dot(camera->getState().direction, camera->sunDir) + 1) * 0.5f), 2.f);
-    glUniform1f(shader.uniform("daytime"), daylight);
-    
-    glm::mat4 view = glm::mat4(glm::mat3(camera->view));
-
-    glUniformMatrix4fv(shader.uniform("view"), 1, GL_FALSE, &view[0][0]);
-    glUniformMatrix4fv(shader.uniform("projection"), 1, GL_FALSE, &camera->projection[0][0]);
+    glUniform1f(shader->uniform(Uniform::daytime), daylight);
 
-    // skybox cube
-    glBindVertexArray(skyboxVAO);
+    // view and projection are read from the PerView block
 
-    cubeMap->bind(0);
-    glUniform1i(shader.uniform("cubemap"), 0);
+    textures.set(0, *cubeMap);
+    glUniform1i(shader->uniform(Uniform::cubemap), 0);
 
-    glDrawArrays(GL_TRIANGLES, 0, 36);
-    
-    glBindVertexArray(0);
-    glDepthFunc(GL_LESS); // set depth function back to default
+    // skybox cube
+    DrawItem skybox;
+    skybox.shader = shader.get();
+    skybox.state = &state;
+    skybox.textures = &textures;
+    skybox.draw = [this]() {
+        GLState::bindVertexArray(skyboxVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+        GLState::countDraw();
+    };
+    Globals::scene->renderQueue.submit(sortKey(skyboxVAO, 1.f), std::move(skybox));
 }
@@ -8,36 +8,36 @@
 
 #include "graphics/gl_error.hpp"
 #include "render_type.hpp"
+#include "graphics/profiler.hpp"
 
 SunRenderer::SunRenderer() {
-    Shader shader = ResourceManager::LoadShader("sun.vert", "sun.frag", "sun");
+    shader = ResourceManager::LoadShader("sun.vert", "sun.frag", "sun");
     sunTexture = ResourceManager::LoadTexture("textures/sun/sun.jpg", "sun_textures");
 
+    state.blend = true;
+
     check_gl_error();
 }
 
 void SunRenderer::render(double dt) {
-    Shader shader = ResourceManager::GetShader("sun");
-    shader.enable();
+    Profiler::CpuScope profile("SunRenderer");
+
+    shader->enable();
     check_gl_error();
 
     // glDisable(GL_BLEND);
     check_gl_error();
 
-    applyUniforms(shader);
+    applyUniforms(*shader);
     check_gl_error();
 
-    Universe universe = Globals::scene->getUniverse();
-    const std::vector<Sun * > & suns = universe.getSuns();
-    std::vector<Renderable *> renderableSuns(suns.begin(), suns.end());
-    
-    draw_objects(renderableSuns, glm::mat4(1.f), shader, RenderType::Terrain, true);
+    submit_objects(Globals::scene->getRenderView().getSuns(), RenderType::Terrain);
 
     check_gl_error();
 }
 
 void SunRenderer::applyUniforms(Shader & shader) {
 
-    sunTexture->bind(0);
-    glUniform1i(shader.uniform("sunTexture"), 0);
+    textures.set(0, *sunTexture);
+    glUniform1i(shader.uniform(Uniform::sunTexture), 0);
 }
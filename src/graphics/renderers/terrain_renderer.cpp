@@ -8,9 +8,10 @@
 
 #include "graphics/gl_error.hpp"
 #include "render_type.hpp"
+#include "graphics/profiler.hpp"
 
 TerrainRenderer::TerrainRenderer() {
-    Shader shader = ResourceManager::LoadShader("terrain.vert", "terrain.frag", "terrain");
+    shader = ResourceManager::LoadShader("terrain.vert", "terrain.frag", "terrain");
     terrainTextures = ResourceManager::LoadTextureArray({
         "textures/tc_sand.dds",
         "textures/tc_sand_normal.dds",
@@ -32,27 +33,23 @@ TerrainRenderer::TerrainRenderer() {
     // sand = ResourceManager::LoadTexture("textures/tc_sand.dds", "sand");
     // snow = ResourceManager::LoadTexture("textures/snow512.tga", "snow");
 
-    Renderer::shadows = true;
-
     check_gl_error();
 }
 
 void TerrainRenderer::render(double dt) {
-    Shader shader = ResourceManager::GetShader("terrain");
-    shader.enable();
-    check_gl_error();
+    Profiler::CpuScope profile("TerrainRenderer");
 
-    glDisable(GL_BLEND);
+    shader->enable();
     check_gl_error();
 
-    applyUniforms(shader);
+    applyUniforms(*shader);
     check_gl_error();
 
-    Universe universe = Globals::scene->getUniverse();
+    const RenderView & view = Globals::scene->getRenderView();
 
 //    universe.getPlanet()->terrainMesh->render();
 
-    draw_objects(universe.getRenderables(), glm::mat4(1.f), shader, RenderType::Terrain, true);
+    submit_objects(view.getRenderables(), RenderType::Terrain);
     
     // for (auto &planet : universe.getRenderables()) {
     //     planet->render(RenderType::Terrain);
@@ -77,23 +74,22 @@ void TerrainRenderer::applyUniforms(Shader & shader) {
     // glUniform1f(shader.uniform("time"), universe.getTime());
     // glUniform2f(shader.uniform("scrSize"), WindowSize::widthPixels, WindowSize::heightPixels);
     // glUniform3f(shader.uniform("camPos"), camera.position.x, camera.position.y, camera.position.z);
-    glUniform3f(shader.uniform("sunDir"), camera->sunDir.x, camera->sunDir.y, camera->sunDir.z);
     // glUniform3f(shader.uniform("planetCenter"), 0.f, 0.f, 0.f);
     // glUniform1f(shader.uniform("seaLevel"), 150.f);
     
-    glUniform1i(shader.uniform("backgroundTerrainLayer"), 0);
-    glUniform4f(shader.uniform("terrainLayers"), 2, 4, 5, 6);
-    glUniform4i(shader.uniform("hasNormal"), 1, 0, 0, 1); // (background must have normal)
-    glUniform4i(shader.uniform("fadeBlend"), 0, 0, 0, 1);
-    glUniform4f(shader.uniform("specularity"), .4, 0, 0, .6);
-    glUniform4f(shader.uniform("textureScale"), 2.2, 1., 1., 1.5);
+    glUniform1i(shader.uniform(Uniform::backgroundTerrainLayer), 0);
+    glUniform4f(shader.uniform(Uniform::terrainLayers), 2, 4, 5, 6);
+    glUniform4i(shader.uniform(Uniform::hasNormal), 1, 0, 0, 1); // (background must have normal)
+    glUniform4i(shader.uniform(Uniform::fadeBlend), 0, 0, 0, 1);
+    glUniform4f(shader.uniform(Uniform::specularity), .4, 0, 0, .6);
+    glUniform4f(shader.uniform(Uniform::textureScale), 2.2, 1., 1., 1.5);
 
-    terrainTextures->bind(0);
-    glUniform1i(shader.uniform("terrainTextures"), 0);
+    textures.set(0, *terrainTextures);
+    glUniform1i(shader.uniform(Uniform::terrainTextures), 0);
 
     // Bind results from other buffers
-    Globals::scene->shadow_renderer->sunDepthTexture->bind(1);
-    glUniform1i(shader.uniform("shadowBuffer"), 1);
+    textures.set(1, *Globals::scene->frameGraph.getTextureArray("shadow_map"));
+    glUniform1i(shader.uniform(Uniform::shadowBuffer), 1);
 
     // grass->bind(2);
     // glUniform1i(shader.uniform("grassTexture"), 2);
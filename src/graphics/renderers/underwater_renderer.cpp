@@ -5,53 +5,55 @@
 #include "graphics/camera.hpp"
 #include "common/universe.hpp"
 #include "utils/resource_manager.hpp"
+#include "graphics/vert_buffer.hpp"
 
 #include "render_type.hpp"
 
-UnderwaterRenderer::UnderwaterRenderer(): underwaterBuffer(1024, 1024) {
-    underwaterBuffer.addColorTexture(GL_RGBA, GL_LINEAR, GL_LINEAR);
-    underwaterBuffer.addDepthTexture(GL_LINEAR, GL_LINEAR);
+UnderwaterRenderer::UnderwaterRenderer() {
+    underwaterBuffer = Globals::scene->renderTargets.acquire({1024, 1024, GL_RGBA, true});
 
-    Shader shader = ResourceManager::LoadShader("underwater.vert", "underwater.frag", "underwater");
+    shader = ResourceManager::LoadShader("underwater.vert", "underwater.frag", "underwater");
     check_gl_error();
 
     caustics = ResourceManager::LoadTexture("textures/tc_caustics.dds", "caustics");
     sand = ResourceManager::LoadTexture("textures/tc_sand.dds", "sand");
+
+    state.blend = true;
 }
 
 void UnderwaterRenderer::render(double dt) {
-    Universe universe = Globals::scene->getUniverse();
+    const RenderView & renderView = Globals::scene->getRenderView();
+
+    // The caustics move with the time
+    PassInputs inputs = {camera->combined, renderView.getTransformVersion(), VertBuffer::getUploadVersion(), Globals::scene->getUniverse().getTime()};
+    if (!cache.needsUpdate(inputs)) return;
 
-    underwaterBuffer.bind();
-    glEnable(GL_BLEND);
+    underwaterBuffer->bind();
 
     glClearColor(0, 0, 0, 1);
+    GLState::setDepthMask(true); // glClear respects the depth mask
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    Shader shader = ResourceManager::GetShader("underwater");    
-    shader.enable();
+    shader->enable();
 
-    applyUniforms(shader);
+    applyUniforms(*shader);
     
-    draw_objects(universe.getRenderables(), glm::mat4(1.f), shader, RenderType::Terrain, true);
+    submit_objects(renderView.getRenderables(), RenderType::Terrain);
 
-    underwaterBuffer.unbind();
+    // This pass has its own target, so it is drawn right away
+    Globals::scene->renderQueue.flush();
+
+    underwaterBuffer->unbind();
 }
 
 void UnderwaterRenderer::applyUniforms(Shader & shader) {
-    
-    Universe universe = Globals::scene->getUniverse();
 
-    // glUniformMatrix4fv(shader.uniform("viewProjection"), 1, GL_FALSE, &camera.combined[0][0]);
-    glUniform1f(shader.uniform("time"), universe.getTime());
-    // glUniform2f(shader.uniform("scrSize"), WindowSize::widthPixels, WindowSize::heightPixels);
-    // glUniform3f(shader.uniform("camPos"), camera.position.x, camera.position.y, camera.position.z);
-    glUniform3f(shader.uniform("sunDir"), camera->sunDir.x, camera->sunDir.y, camera->sunDir.z);
+    // time and sunDir are read from the PerFrame block
 
     // Bind Textures
-    caustics->bind(0);
-    glUniform1i(shader.uniform("causticsSheet"), 0);
+    textures.set(0, *caustics);
+    glUniform1i(shader.uniform(Uniform::causticsSheet), 0);
 
-    sand->bind(1);
-    glUniform1i(shader.uniform("terrainTexture"), 1);
+    textures.set(1, *sand);
+    glUniform1i(shader.uniform(Uniform::terrainTexture), 1);
 }
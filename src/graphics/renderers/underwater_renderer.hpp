@@ -7,6 +7,7 @@
 
 #include "graphics/texture.hpp"
 #include "graphics/frame_buffer.hpp"
+#include "graphics/pass_cache.hpp"
 
 class UnderwaterRenderer: public Renderer {
     private:
@@ -14,6 +15,10 @@ class UnderwaterRenderer: public Renderer {
         void applyUniforms(Shader & shader);
     public: 
         UnderwaterRenderer();
-        FrameBuffer underwaterBuffer;
+        // Owned by the pass (never released), it keeps the result while the cache is valid
+        FrameBuffer * underwaterBuffer;
+
+        // Skips the pass when the camera, the bodies, the meshes and the time are the same as last time
+        PassCache cache;
         void render(double dt);
 };
\ No newline at end of file
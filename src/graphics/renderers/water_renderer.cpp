@@ -7,57 +7,51 @@
 #include "utils/resource_manager.hpp"
 
 #include "render_type.hpp"
+#include "graphics/profiler.hpp"
 
 WaterRenderer::WaterRenderer() {
-    Shader shader = ResourceManager::LoadShader("water.vert", "water.frag", "water");
+    shader = ResourceManager::LoadShader("water.vert", "water.frag", "water");
     check_gl_error();
 
     foamTexture = ResourceManager::LoadTexture("textures/tc_foam.dds", "foam");
     seaWaves = ResourceManager::LoadTexture("textures/sea_waves.dds", "seaWaves");
 
-    Renderer::shadows = true;
+    state.blend = true;
 }
 
 void WaterRenderer::render(double dt) {
-    Shader shader = ResourceManager::GetShader("water");
-    shader.enable();
+    Profiler::CpuScope profile("WaterRenderer");
 
-    glEnable(GL_BLEND);
+    shader->enable();
 
-    applyUniforms(shader);
+    applyUniforms(*shader);
 
-    Universe universe = Globals::scene->getUniverse();
+    const RenderView & view = Globals::scene->getRenderView();
 
-    // We don't need to update the models since the terrain renderer will already have done that
-    draw_objects(universe.getRenderables(), glm::mat4(1.f), shader, RenderType::Water, false);
+    submit_objects(view.getRenderables(), RenderType::Water);
 }
 
 void WaterRenderer::applyUniforms(Shader & shader) {
-    Universe universe = Globals::scene->getUniverse();
-
-    // glUniformMatrix4fv(shader.uniform("viewProjection"), 1, GL_FALSE, &camera.combined[0][0]);
-    glUniform1f(shader.uniform("time"), universe.getTime());
-    glUniform2f(shader.uniform("scrSize"), WindowSize::widthPixels, WindowSize::heightPixels);
-    glUniform3fv(shader.uniform("camPos"), 1, glm::value_ptr(camera->getPosition())); //camera.position.x, camera.position.y, camera.position.z);
-    glUniform3fv(shader.uniform("sunDir"), 1, glm::value_ptr(camera->sunDir));
+    // time, scrSize, camPos and sunDir are read from the PerFrame and PerView blocks
 
     // Bind Textures
-    foamTexture->bind(0);
-    glUniform1i(shader.uniform("foamTexture"), 0);
+    textures.set(0, *foamTexture);
+    glUniform1i(shader.uniform(Uniform::foamTexture), 0);
 
-    seaWaves->bind(1);
-    glUniform1i(shader.uniform("seaWaves"), 1);
+    textures.set(1, *seaWaves);
+    glUniform1i(shader.uniform(Uniform::seaWaves), 1);
 
-    // Bind results from other buffers
-    Globals::scene->underwater_renderer->underwaterBuffer.colorTexture->bind(2);
-    glUniform1i(shader.uniform("underwaterTexture"), 2);
+    // Bind results from other passes, declared as reads of the scene pass
+    FrameBuffer * underwater = Globals::scene->frameGraph.getTarget("underwater");
+    textures.set(2, *underwater->colorTexture);
+    glUniform1i(shader.uniform(Uniform::underwaterTexture), 2);
 
-    Globals::scene->underwater_renderer->underwaterBuffer.depthTexture->bind(3);
-    glUniform1i(shader.uniform("underwaterDepthTexture"), 3);
+    textures.set(3, *underwater->depthTexture);
+    glUniform1i(shader.uniform(Uniform::underwaterDepthTexture), 3);
 
     // Bind results from other buffers
-    Globals::scene->shadow_renderer->sunDepthTexture->bind(4);
-    glUniform1i(shader.uniform("shadowBuffer"), 4);
+    textures.set(4, *Globals::scene->frameGraph.getTextureArray("shadow_map"));
+    glUniform1i(shader.uniform(Uniform::shadowBuffer), 4);
 
     // reflectionBuffer.colorTexture->bind(4,"reflectionTexture");
     // glUniform1i(shader.uniform("reflectionTexture"), 4);
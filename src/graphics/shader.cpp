@@ -20,6 +20,10 @@
 // Adapted from r3dux (http://r3dux.org).
 
 #include "shader.hpp"
+#include "uniform_buffer.hpp"
+#include "multi_draw.hpp"
+
+#include <algorithm>
 
 #ifndef SHADER_DIR
 #define SHADER_DIR ""
@@ -29,6 +33,15 @@
 //	Implementation
 //
 
+const char *Uniform::name( Id id ){
+	static const char *names[] = {
+#define UNIFORM_NAME(name) #name,
+		SHADER_UNIFORMS(UNIFORM_NAME)
+#undef UNIFORM_NAME
+	};
+	return names[id];
+}
+
 GLuint Shader::compile( std::string source, GLenum type ){
 
 	// Generate a shader id
@@ -83,6 +96,10 @@ void Shader::init(std::string vertex_source, std::string frag_source){
 
 //	 check_gl_error();
 
+	// Vertex shaders that can read their model from the PerDraw block get the multi draw header instead of their #version
+	multiDraw = MultiDraw::supported() && vertex_source.find("MULTI_DRAW") != std::string::npos;
+	if( multiDraw ){ vertex_source.replace(0, vertex_source.find('\n') + 1, MultiDraw::vertexHeader()); }
+
 	// Compile the shaders and return their id values
 	vertex_id = compile(vertex_source, GL_VERTEX_SHADER);
 	fragment_id = compile(frag_source, GL_FRAGMENT_SHADER);
@@ -130,7 +147,45 @@ void Shader::init(std::string vertex_source, std::string frag_source){
 	}
 	check_gl_error();
 
-	glUseProgram(0);
+	reflect();
+
+	GLState::useProgram(0);
+	check_gl_error();
+}
+
+void Shader::reflect(){
+	uniforms.clear();
+
+	GLint count = 0, maxLength = 0;
+	glGetProgramiv(program_id, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(program_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	std::vector<GLchar> nameBuffer(std::max(maxLength, 1));
+	for( GLint i = 0; i < count; i++ ){
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(program_id, i, (GLsizei) nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+
+		// Arrays are reported as "name[0]", but are set through "name"
+		std::string name(nameBuffer.data(), length);
+		if( name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0 ){ name.resize(name.size() - 3); }
+
+		// Uniforms inside a uniform block have no location
+		GLint location = glGetUniformLocation(program_id, name.c_str());
+		if( location != -1 ){ uniforms[name] = location; }
+	}
+
+	for( unsigned int id = 0; id < Uniform::COUNT; id++ ){
+		auto it = uniforms.find(Uniform::name((Uniform::Id) id));
+		locations[id] = it == uniforms.end() ? -1 : it->second;
+	}
+
+	// GLSL 330 has no binding qualifier, so the shared blocks are bound to their fixed points here
+	for( unsigned int binding = 0; binding < UniformBlock::COUNT; binding++ ){
+		GLuint index = glGetUniformBlockIndex(program_id, UniformBlock::name((UniformBlock::Binding) binding));
+		if( index != GL_INVALID_INDEX ){ glUniformBlockBinding(program_id, index, binding); }
+	}
 	check_gl_error();
 }
 
@@ -192,7 +247,7 @@ void Shader::init_from_files( std::string vertex_file, std::string frag_file){
 
 
 void Shader::enable(){
-	if( program_id!=0 ){glUseProgram(program_id);}
+	if( program_id!=0 ){GLState::useProgram(program_id);}
 	else{ throw std::runtime_error("\n**Shader Error: Can't enable, not initialized"); }
 }
 
@@ -210,10 +265,8 @@ GLuint Shader::attribute(const std::string name){
 
 GLuint Shader::uniform(const std::string name){
 
-	// Add the uniform to the map table if it doesn't already exist
-	if( uniforms.count(name)==0 ){ 
-		uniforms[name] = glGetUniformLocation( program_id, name.c_str() );
-		if( uniforms[name] == (GLuint) -1 ){ throw std::runtime_error("\n**Shader Error: bad uniform ("+name+")"); }
-	}
-	return uniforms[name];
+	// All active uniforms are in the map since linking
+	auto it = uniforms.find(name);
+	if( it == uniforms.end() ){ throw std::runtime_error("\n**Shader Error: bad uniform ("+name+")"); }
+	return it->second;
 }
@@ -31,9 +31,12 @@
 #include <fstream>
 #include <sstream>
 #include <vector>
+#include <array>
+#include <memory>
 #include <unordered_map> // requires C++11
 
 #include "gl_error.hpp"
+#include "gl_state.hpp"
 //
 //	Shader utility class for managing vert/frag shaders.
 //	Does not currently handle geometry shaders.
@@ -51,9 +54,40 @@
 //	}
 //
 
+
+//	Uniforms with a fixed id. Their locations are looked up once after linking,
+//	so shader.uniform(Uniform::MVP) is an array lookup instead of a string hash.
+//	Add new names here when a shader needs them every frame.
+//	Camera, sun and time uniforms are not set per shader, they live in the
+//	PerFrame and PerView blocks of uniform_buffer.hpp.
+//
+#define SHADER_UNIFORMS(X) \
+	X(MVP) X(model) X(resolution) X(mvp) X(up) X(right) X(spawnPoints) X(cloudDistance) X(noiseTex) \
+	X(foamTexture) X(seaWaves) X(underwaterTexture) X(underwaterDepthTexture) X(shadowBuffer) \
+	X(terrainTextures) X(backgroundTerrainLayer) X(terrainLayers) X(hasNormal) X(fadeBlend) \
+	X(specularity) X(textureScale) X(causticsSheet) X(terrainTexture) X(sunTexture) \
+	X(atmosphere) X(daytime) X(cubemap) X(textures) X(sunScreenPosition) X(sunDepth) \
+	X(zoomEffect) X(zoom) X(scene) X(sceneDepth) X(inverseViewProjection) X(transmittanceLUT) \
+	X(scatteringLUT) X(planetCenter) X(sunDirection) X(rayleighScattering) X(planetRadius) \
+	X(atmosphereRadius) X(mieG) X(sunIntensity) X(flareIntensity) X(flareRotation)
+
+namespace Uniform {
+	enum Id : unsigned int {
+#define UNIFORM_ID(name) name,
+		SHADER_UNIFORMS(UNIFORM_ID)
+#undef UNIFORM_ID
+		COUNT
+	};
+
+	const char *name( Id id );
+}
+
+class Shader;
+typedef std::shared_ptr<Shader> SharedShader;
+
 class Shader {
 public:
-	Shader() : program_id(0) {}
+	Shader() : program_id(0) { locations.fill(-1); }
 
 	// Init the shader from files (must create OpenGL context first!)
 	void init_from_files( std::string vertex_file, std::string frag_file );
@@ -65,7 +99,7 @@ public:
 	void enable();
 
 	// Not really needed, but nice for readability
-	void disable(){ glUseProgram(0); }
+	void disable(){ GLState::useProgram(0); }
 
 	// Returns the bound location of a named attribute
 	GLuint attribute( const std::string name );
@@ -73,21 +107,31 @@ public:
 	// Returns the bound location of a named uniform
 	GLuint uniform( const std::string name );
 
+	// Returns the location of a uniform with a fixed id, -1 (ignored by glUniform*) if the shader does not use it
+	inline GLint uniform( Uniform::Id id ) const { return locations[id]; }
+
 	void bind_texture(int unit, std::string texture, std::string unifrom);
 
 	void validate( );
  
 	GLuint program_id;
+
+	// True when the model matrix comes from the PerDraw block of MultiDraw instead of the model uniform
+	bool multiDraw = false;
 private:
 	GLuint vertex_id;
 	GLuint fragment_id;
 
 	std::unordered_map<std::string, GLuint> attributes;
-	std::unordered_map<std::string, GLuint> uniforms;
+	std::unordered_map<std::string, GLint> uniforms;
+	std::array<GLint, Uniform::COUNT> locations;
 
 	// Initialize the shader, called by init_from_*
 	void init( std::string vertex_source, std::string frag_source );
 
+	// Looks up all active uniforms once, called by init after linking
+	void reflect();
+
 	// Compiles the shader, called by init
 	GLuint compile( std::string shaderSource, GLenum type );
 
@@ -1,6 +1,9 @@
 
 #include "tangent_calculator.hpp"
 
+// Local Headers
+#include "utils/parallel.h"
+
 namespace TangentCalculator
 {
 
@@ -12,8 +15,8 @@ using namespace glm;
  * https://youtu.be/4DUfwAEx4Ts?t=423
  */
 vec3 calculateTangent(
-    vec3 &p0, vec3 &p1, vec3 &p2,
-    vec2 &uv0, vec2 &uv1, vec2 &uv2)
+    const vec3 &p0, const vec3 &p1, const vec3 &p2,
+    const vec2 &uv0, const vec2 &uv1, const vec2 &uv2)
 {
     vec3 deltaPos1 = vec3(p1 - p0);
     vec3 deltaPos2 = vec3(p2 - p0);
@@ -39,21 +42,29 @@ void addTangentsToMesh(Mesh *mesh)
     int texOffset = attrs.getOffset(VertAttributes::TEX_COORDS);
     int tanOffset = attrs.getOffset(VertAttributes::TANGENT);
 
-    for (unsigned int i = 0; i < mesh->nrOfIndices; i += 3)
-    {
-        int vertI0 = mesh->indices[i], vertI1 = mesh->indices[i + 1], vertI2 = mesh->indices[i + 2];
-        auto p0 = mesh->get<vec3>(vertI0, posOffset),
-             p1 = mesh->get<vec3>(vertI1, posOffset),
-             p2 = mesh->get<vec3>(vertI2, posOffset);
-        auto uv0 = mesh->get<vec2>(vertI0, texOffset),
-             uv1 = mesh->get<vec2>(vertI1, texOffset),
-             uv2 = mesh->get<vec2>(vertI2, texOffset);
-        auto tangent = calculateTangent(p0, p1, p2, uv0, uv1, uv2);
-        mesh->add<vec3>(tangent, vertI0, tanOffset);
-        mesh->add<vec3>(tangent, vertI1, tanOffset);
-        mesh->add<vec3>(tangent, vertI2, tanOffset);
-    }
-    mesh->normalizeVecAttribute<vec3>(tanOffset);
+    const MeshTopology &topo = mesh->getTopology();
+    unsigned int nrOfTriangles = mesh->nrOfIndices / 3;
+
+    auto positions = mesh->view<const vec3>(posOffset);
+    auto texCoords = mesh->view<const vec2>(texOffset);
+    auto tangents = mesh->view<vec3>(tanOffset);
+
+    std::vector<vec3> faceTangents(nrOfTriangles);
+    parallel::forEach(nrOfTriangles, [&](unsigned int f) {
+        int vertI0 = mesh->indices[3 * f], vertI1 = mesh->indices[3 * f + 1], vertI2 = mesh->indices[3 * f + 2];
+        faceTangents[f] = calculateTangent(
+            positions[vertI0], positions[vertI1], positions[vertI2],
+            texCoords[vertI0], texCoords[vertI1], texCoords[vertI2]);
+    });
+
+    // Gather instead of adding to the vertices of each triangle, so vertices can be processed in parallel
+    parallel::forEach(mesh->nrOfVertices, [&](unsigned int i) {
+        vec3 tangent(0.f);
+        for (unsigned int t = topo.triangleOffsets[i]; t < topo.triangleOffsets[i + 1]; t++)
+            tangent += faceTangents[topo.vertexTriangles[t]];
+
+        tangents[i] = normalize(tangent);
+    });
 }
 
 } // namespace TangentCalculator
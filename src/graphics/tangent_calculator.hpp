@@ -16,8 +16,8 @@ namespace TangentCalculator
  * https://youtu.be/4DUfwAEx4Ts?t=423
  */
 glm::vec3 calculateTangent(
-    glm::vec3 &p0, glm::vec3 &p1, glm::vec3 &p2,
-    glm::vec2 &uv0, glm::vec2 &uv1, glm::vec2 &uv2);
+    const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2,
+    const glm::vec2 &uv0, const glm::vec2 &uv1, const glm::vec2 &uv2);
 
 /**
  * Adds Tangents to mesh.
@@ -5,6 +5,8 @@
 
 // Local Headers
 #include "graphics/gl_error.hpp"
+#include "graphics/gl_state.hpp"
+#include "graphics/profiler.hpp"
 
 
 Texture::Texture()
@@ -25,6 +27,8 @@ Texture::Texture()
 
 void Texture::generate(unsigned int width, unsigned int height, unsigned char* data)
 {
+    Profiler::CpuScope profile("Texture::generate");
+
     this->width = width;
     this->height = height;
 
@@ -54,6 +58,8 @@ void Texture::generate(unsigned int width, unsigned int height, unsigned char* d
 }
 
 void Texture::generateCompressed(unsigned int width, unsigned int height, unsigned int blockSize, unsigned char* data) {
+    Profiler::CpuScope profile("Texture::generateCompressed");
+
     this->width = width;
     this->height = height;
 
@@ -83,8 +89,7 @@ void Texture::generateCompressed(unsigned int width, unsigned int height, unsign
 
 void Texture::bind(GLuint unit)
 {
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(GL_TEXTURE_2D, id);
+    GLState::bindTexture(unit, GL_TEXTURE_2D, id);
 }
 
 Texture::~Texture()
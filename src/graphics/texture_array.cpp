@@ -5,6 +5,8 @@
 
 // Local Headers
 #include "graphics/gl_error.hpp"
+#include "graphics/gl_state.hpp"
+#include "graphics/profiler.hpp"
 
 
 TextureArray::TextureArray(): 
@@ -22,6 +24,8 @@ TextureArray::TextureArray():
 
 void TextureArray::generate(unsigned int width, unsigned int height, unsigned int layers, unsigned char ** buffers)
 {
+    Profiler::CpuScope profile("TextureArray::generate");
+
     this->width = width;
     this->height = height;
     this->layers = layers;
@@ -64,10 +68,38 @@ void TextureArray::generate(unsigned int width, unsigned int height, unsigned in
     glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 }
 
+void TextureArray::generateDepth(unsigned int width, unsigned int height, unsigned int layers)
+{
+    this->width = width;
+    this->height = height;
+    this->layers = layers;
+
+    Internal_Format = GL_DEPTH_COMPONENT32F;
+    Image_Format = GL_DEPTH_COMPONENT;
+    Texture_Type = GL_FLOAT;
+    Max_Level = 0;
+
+    check_gl_error();
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->id);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, Max_Level);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, Internal_Format, width, height, layers, 0, Image_Format, Texture_Type, NULL);
+
+    check_gl_error();
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
 void TextureArray::bind(GLuint unit)
 {
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+    GLState::bindTexture(unit, GL_TEXTURE_2D_ARRAY, id);
 }
 
 TextureArray::~TextureArray()
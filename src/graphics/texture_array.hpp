@@ -27,5 +27,8 @@ class TextureArray
     ~TextureArray();
 
     void generate(unsigned int width, unsigned int height, unsigned int layers, unsigned char ** buffers);
+
+    // Empty GL_DEPTH_COMPONENT32F layers without mipmaps, to render depth into (see FrameBuffer::bindDepthLayer)
+    void generateDepth(unsigned int width, unsigned int height, unsigned int layers);
     void bind(GLuint unit);
 };
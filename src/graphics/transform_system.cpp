@@ -0,0 +1,111 @@
+#include "transform_system.hpp"
+
+// Standard Headers
+#include <string>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define TRANSFORM_SSE
+#include <xmmintrin.h>
+#endif
+
+void TransformSystem::clear()
+{
+    parents.clear();
+    locals.clear();
+    worlds.clear();
+    changed.clear();
+}
+
+unsigned int TransformSystem::addNode(int parent, const glm::mat4 & local)
+{
+    unsigned int node = parents.size();
+    if (parent >= (int) node) throw "TransformSystem: the parent of node " + std::to_string(node) + " has to come before it";
+
+    parents.push_back(parent);
+    locals.push_back(local);
+    changed.push_back(true);
+    if (node / 4 >= worlds.size()) worlds.emplace_back();
+
+    return node;
+}
+
+void TransformSystem::setLocal(unsigned int node, const glm::mat4 & local)
+{
+    // Setters of a Renderable mark it dirty even when the value stays the same (a paused simulation)
+    if (locals[node] == local) return;
+
+    locals[node] = local;
+    changed[node] = true;
+}
+
+bool TransformSystem::update()
+{
+    bool updated = false;
+
+    // Parents come first, so their flag and world matrix are final when their children are reached
+    for (unsigned int node = 0; node < parents.size(); node++)
+    {
+        int parent = parents[node];
+        if (parent >= 0 && changed[parent]) changed[node] = true;
+        if (!changed[node]) continue;
+
+        setWorld(node, parent < 0 ? locals[node] : getWorld(parent) * locals[node]);
+        updated = true;
+    }
+    changed.assign(changed.size(), false);
+    return updated;
+}
+
+glm::mat4 TransformSystem::getWorld(unsigned int node) const
+{
+    const Block &block = worlds[node / 4];
+    unsigned int lane = node % 4;
+
+    glm::mat4 world;
+    for (int e = 0; e < 16; e++) world[e / 4][e % 4] = block.m[e][lane];
+    return world;
+}
+
+void TransformSystem::setWorld(unsigned int node, const glm::mat4 & world)
+{
+    Block &block = worlds[node / 4];
+    unsigned int lane = node % 4;
+
+    for (int e = 0; e < 16; e++) block.m[e][lane] = world[e / 4][e % 4];
+}
+
+void TransformSystem::computeMVPs(const glm::mat4 & vp, std::vector<glm::mat4> & mvps) const
+{
+    unsigned int nrOfNodes = size();
+    mvps.resize(nrOfNodes);
+
+    for (unsigned int b = 0; b * 4 < nrOfNodes; b++)
+    {
+        const Block &world = worlds[b];
+        Block mvp;
+
+        // (vp * world)[c][r] = sum over k of vp[k][r] * world[c][k], for the 4 lanes at once
+        for (int c = 0; c < 4; c++)
+        {
+            for (int r = 0; r < 4; r++)
+            {
+                #ifdef TRANSFORM_SSE
+                __m128 sum = _mm_mul_ps(_mm_set1_ps(vp[0][r]), _mm_load_ps(world.m[c * 4]));
+                for (int k = 1; k < 4; k++)
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(vp[k][r]), _mm_load_ps(world.m[c * 4 + k])));
+                _mm_store_ps(mvp.m[c * 4 + r], sum);
+                #else
+                for (int lane = 0; lane < 4; lane++)
+                {
+                    float sum = 0;
+                    for (int k = 0; k < 4; k++) sum += vp[k][r] * world.m[c * 4 + k][lane];
+                    mvp.m[c * 4 + r][lane] = sum;
+                }
+                #endif
+            }
+        }
+
+        for (unsigned int lane = 0; lane < 4 && b * 4 + lane < nrOfNodes; lane++)
+            for (int e = 0; e < 16; e++) mvps[b * 4 + lane][e / 4][e % 4] = mvp.m[e][lane];
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+// Standard Headers
+#include <vector>
+#include <glm/mat4x4.hpp>
+
+/**
+ * Flattened transform hierarchy: an array of nodes with a parent index, a local and a world matrix.
+ *
+ * Nodes are stored in topological order (parents before their children), so update() computes
+ * all world matrices in one linear sweep, without recursion or pointer chasing.
+ * Only nodes whose local matrix was set since the last update(), or whose parent changed, are recomputed,
+ * so a static hierarchy costs one flag test per node per frame.
+ *
+ * The world matrices are stored as a structure of arrays in blocks of 4: block.m[e] holds element e
+ * (column * 4 + row) of 4 consecutive nodes, 16 byte aligned. computeMVPs() multiplies 4 matrices
+ * per iteration with SSE that way, without shuffles.
+ */
+class TransformSystem
+{
+  public:
+    void clear();
+
+    /**
+     * Appends a node, parent has to be an earlier node or -1 for a root. Returns the index of the node.
+     */
+    unsigned int addNode(int parent, const glm::mat4 & local = glm::mat4(1.f));
+
+    /**
+     * Does nothing when local is the current local matrix of the node.
+     */
+    void setLocal(unsigned int node, const glm::mat4 & local);
+
+    /**
+     * world = world of parent * local, for the nodes that changed since the last update.
+     * Returns false when no world matrix changed.
+     */
+    bool update();
+
+    glm::mat4 getWorld(unsigned int node) const;
+
+    int getParent(unsigned int node) const { return parents[node]; }
+
+    unsigned int size() const { return parents.size(); }
+
+    /**
+     * mvps[i] = viewProjection * world of node i, for all nodes.
+     */
+    void computeMVPs(const glm::mat4 & viewProjection, std::vector<glm::mat4> & mvps) const;
+
+  private:
+    struct alignas(16) Block {
+        float m[16][4];
+    };
+
+    std::vector<int> parents;
+    std::vector<glm::mat4> locals;
+    std::vector<Block> worlds;
+
+    // Set by setLocal(), cleared by update() after the world matrix of the node has been recomputed
+    std::vector<bool> changed;
+
+    void setWorld(unsigned int node, const glm::mat4 & world);
+};
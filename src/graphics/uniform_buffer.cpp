@@ -0,0 +1,99 @@
+#include "uniform_buffer.hpp"
+
+// Standard Headers
+#include <cstring>
+#include <iostream>
+#include <string>
+
+const char *UniformBlock::name(Binding binding)
+{
+    static const char *names[] = {"PerFrame", "PerView"};
+    return names[binding];
+}
+
+UniformBuffer::UniformBuffer(UniformBlock::Binding binding, GLsizeiptr blockSize, unsigned int writesPerFrame)
+    : binding(binding), blockSize(blockSize), writesPerFrame(writesPerFrame)
+{
+    // Every slot has to start at a multiple of the offset alignment of glBindBufferRange
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    slotSize = ((blockSize + alignment - 1) / alignment) * alignment;
+
+    GLsizeiptr size = slotSize * writesPerFrame * FRAMES_IN_FLIGHT;
+
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_UNIFORM_BUFFER, id);
+
+    #ifdef GL_VERSION_4_4
+    if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_UNIFORM_BUFFER, size, NULL, flags);
+        mapped = (unsigned char *) glMapBufferRange(GL_UNIFORM_BUFFER, 0, size, flags);
+    }
+    #endif
+
+    if (!mapped) glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    std::cout << "UniformBuffer " << UniformBlock::name(binding) << " created with " << writesPerFrame << " slots per frame"
+              << (mapped ? " (persistently mapped)\n" : "\n");
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    for (GLsync &fence : fences)
+        if (fence) glDeleteSync(fence);
+
+    if (mapped)
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, id);
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &id);
+}
+
+void UniformBuffer::write(const void *block)
+{
+    if (slot == writesPerFrame) throw "UniformBuffer " + std::string(UniformBlock::name(binding)) + " is written more than " + std::to_string(writesPerFrame) + " times in one frame";
+
+    lastOffset = (frame * writesPerFrame + slot++) * slotSize;
+
+    if (mapped)
+        std::memcpy(mapped + lastOffset, block, blockSize);
+    else
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, id);
+        glBufferSubData(GL_UNIFORM_BUFFER, lastOffset, blockSize, block);
+    }
+    bind();
+}
+
+void UniformBuffer::bind() const
+{
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, id, lastOffset, blockSize);
+}
+
+void UniformBuffer::nextFrame()
+{
+    slot = 0;
+    if (!mapped)
+    {
+        frame = (frame + 1) % FRAMES_IN_FLIGHT;
+        return;
+    }
+
+    // Mark the end of the draws that read the current region
+    if (fences[frame]) glDeleteSync(fences[frame]);
+    fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    frame = (frame + 1) % FRAMES_IN_FLIGHT;
+
+    // Only blocks when the GPU is more than FRAMES_IN_FLIGHT frames behind
+    if (!fences[frame]) return;
+    while (glClientWaitSync(fences[frame], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+    glDeleteSync(fences[frame]);
+    fences[frame] = 0;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+// System Headers
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Standard Headers
+#include <vector>
+
+/**
+ * Fixed binding points of the uniform blocks shared by all shaders.
+ * Shader::reflect() binds every block it finds by name to these points.
+ */
+namespace UniformBlock {
+    enum Binding : GLuint {
+        PER_FRAME = 0,
+        PER_VIEW = 1,
+        COUNT
+    };
+
+    const char *name(Binding binding);
+}
+
+/**
+ * std140 mirror of the PerFrame block:
+ *
+ * layout(std140) uniform PerFrame {
+ *     vec3 sunDir;
+ *     float time;
+ *     vec2 scrSize;
+ * };
+ */
+struct PerFrameUniforms {
+    glm::vec3 sunDir;
+    float time;
+    glm::vec2 scrSize;
+    float padding[2];
+};
+
+/**
+ * std140 mirror of the PerView block:
+ *
+ * layout(std140) uniform PerView {
+ *     mat4 viewProjection;
+ *     mat4 view;
+ *     mat4 projection;
+ *     mat4 shadowMatrices[4];
+ *     vec4 cascadeSplits;
+ *     vec3 camPos;
+ * };
+ *
+ * shadowMatrices[i] transforms world space to cascade i of the shadow map of the sun (bias included),
+ * cascade i is used up to a depth of cascadeSplits[i] in the view of the main camera.
+ */
+struct PerViewUniforms {
+    glm::mat4 viewProjection;
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 shadowMatrices[4];
+    glm::vec4 cascadeSplits;
+    glm::vec3 camPos;
+    float padding;
+};
+
+static_assert(sizeof(PerFrameUniforms) == 32, "PerFrameUniforms does not match the std140 layout");
+static_assert(sizeof(PerViewUniforms) == 7 * 64 + 2 * 16, "PerViewUniforms does not match the std140 layout");
+
+/**
+ * Ring buffer of uniform blocks of one type, bound to a fixed binding point.
+ *
+ * Every write() goes to the next slot of the ring and binds that slot with glBindBufferRange,
+ * so a block can be rewritten several times per frame (once per view for example)
+ * without waiting for the draws that still read the previous contents.
+ *
+ * When GL 4.4 (or ARB_buffer_storage) is available the buffer is persistently mapped and written
+ * with a memcpy, a fence per frame keeps the CPU from overwriting slots the GPU has not read yet.
+ * Otherwise every write is a glBufferSubData into its own slot.
+ */
+class UniformBuffer
+{
+  public:
+    static const unsigned int FRAMES_IN_FLIGHT = 3;
+
+    /**
+     * blockSize: size of the std140 block in bytes.
+     * writesPerFrame: maximum number of writes between two calls to nextFrame().
+     */
+    UniformBuffer(UniformBlock::Binding binding, GLsizeiptr blockSize, unsigned int writesPerFrame);
+
+    ~UniformBuffer();
+
+    /**
+     * Copies the block into the next slot of the ring and binds that slot.
+     */
+    void write(const void *block);
+
+    template <class block>
+    void write(const block &data)
+    {
+        if (sizeof(block) != blockSize) throw "Uniform block size mismatch";
+        write((const void *) &data);
+    }
+
+    /**
+     * Rebinds the slot that was written last.
+     */
+    void bind() const;
+
+    /**
+     * Moves to the next region of the ring, call once per frame before the first write().
+     */
+    void nextFrame();
+
+    const UniformBlock::Binding binding;
+
+  private:
+    GLuint id;
+    GLsizeiptr blockSize, slotSize;
+    unsigned int writesPerFrame, frame = 0, slot = 0;
+    GLintptr lastOffset = 0;
+
+    // Persistently mapped storage, NULL when glBufferSubData is used instead
+    unsigned char *mapped = NULL;
+    GLsync fences[FRAMES_IN_FLIGHT] = {};
+};
@@ -59,6 +59,20 @@ bool VertAttributes::contains(const VertAttr &attr) const
     return false;
 }
 
+bool VertAttributes::operator==(const VertAttributes &other) const
+{
+    if (vertSize != other.vertSize || attributes.size() != other.attributes.size())
+        return false;
+
+    for (unsigned int i = 0; i < attributes.size(); i++)
+    {
+        const VertAttr &a = attributes[i], &b = other.attributes[i];
+        if (a.normalized != b.normalized || a.size != b.size || a.type != b.type || a.name != b.name)
+            return false;
+    }
+    return true;
+}
+
 std::ostream &operator<<(std::ostream &stream, const VertAttributes &attrs)
 {
     stream << "[ ";
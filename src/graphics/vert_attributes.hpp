@@ -68,6 +68,9 @@ public:
 
     bool contains(const VertAttr &attr) const;
 
+    // same attributes in the same order, so the vertices have the same layout.
+    bool operator==(const VertAttributes &other) const;
+
     // to string
     friend std::ostream &operator<<(std::ostream &stream, const VertAttributes &attrs);
 
@@ -5,12 +5,14 @@
 #include <memory>
 #include <string>
 #include <limits>
+#include <algorithm>
+#include <vector>
 
 // Local Headers
 #include "vert_attributes.hpp"
 #include "gl_error.hpp"
-
-GLuint VertBuffer::currentlyBoundVao = 0;
+#include "gl_state.hpp"
+#include "profiler.hpp"
 
 VertBuffer *VertBuffer::with(VertAttributes &attributes)
 {
@@ -22,6 +24,31 @@ void VertBuffer::uploadSingleMesh(SharedMesh mesh)
     with(mesh->attributes)->add(mesh)->upload();
 }
 
+static std::vector<SharedMesh> sharedQueue;
+
+void VertBuffer::addShared(SharedMesh mesh)
+{
+    if (mesh->vertBuffer)
+        throw mesh->name + " was already added to a VertBuffer";
+    sharedQueue.push_back(mesh);
+}
+
+void VertBuffer::uploadShared()
+{
+    std::vector<VertBuffer *> buffers;
+    for (SharedMesh &mesh : sharedQueue)
+    {
+        auto it = std::find_if(buffers.begin(), buffers.end(), [&](VertBuffer *b) { return b->attrs == mesh->attributes; });
+        if (it == buffers.end())
+            it = buffers.insert(buffers.end(), with(mesh->attributes));
+        (*it)->add(mesh);
+    }
+    for (VertBuffer *buffer : buffers)
+        buffer->upload();
+
+    sharedQueue.clear();
+}
+
 VertBuffer::VertBuffer(VertAttributes &attributes)
 : vertSize(attributes.getVertSize()), attrs(attributes)
 {
@@ -30,12 +57,8 @@ VertBuffer::VertBuffer(VertAttributes &attributes)
 
 void VertBuffer::bind()
 {
-    if (currentlyBoundVao != vaoId) // todo: this will break when glBindVertexArray() is called from another place.
-    {
-        glBindVertexArray(vaoId);
-        currentlyBoundVao = vaoId;
-        // vbo and ibo should still be bound at this point.
-    }
+    // vbo and ibo are part of the vao, so they are bound with it.
+    GLState::bindVertexArray(vaoId);
 }
 
 
@@ -68,9 +91,13 @@ VertBuffer *VertBuffer::add(SharedMesh mesh)
 
 void VertBuffer::upload()
 {
+    Profiler::CpuScope profile("VertBuffer::upload");
+
     if (vboId)
         throw "VertBuffer already uploaded";
 
+    uploadVersion++;
+
     // std::cout << "Uploading vbo\n";
     bind();
 
@@ -176,7 +203,7 @@ GLuint VertBuffer::uploadPerInstanceData(VertData data, GLuint advanceRate)
     instanceVboAttrs[id] = data.attributes;
 
     glBindBuffer(GL_ARRAY_BUFFER, instanceVbos[id]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * data.vertices.size(), &data.vertices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, data.vertices.size(), &data.vertices[0], GL_STATIC_DRAW);
     usePerInstanceData(id, advanceRate);
     return id;
 }
@@ -184,6 +211,7 @@ GLuint VertBuffer::uploadPerInstanceData(VertData data, GLuint advanceRate)
 void VertBuffer::onMeshDestroyed()
 {
     std::cout << "A mesh in this VB was destroyed\n";
+    uploadVersion++;
     if (!inUse()) delete this;
 }
 
@@ -208,8 +236,7 @@ VertBuffer::~VertBuffer()
     for (auto &id : instanceVbos)
         if (id != (GLuint) -1) glDeleteBuffers(1, &id);
 
-    if (vaoId == currentlyBoundVao)
-        currentlyBoundVao = 0;
+    GLState::onVertexArrayDeleted(vaoId);
 }
 
 void VertBuffer::usePerInstanceData(GLuint instanceDataId, GLuint advanceRate)
@@ -219,6 +246,12 @@ void VertBuffer::usePerInstanceData(GLuint instanceDataId, GLuint advanceRate)
     setAttrPointersAndEnable(instanceVboAttrs[instanceDataId], advanceRate, attrs.nrOfAttributes());
 }
 
+void VertBuffer::updatePerInstanceData(GLuint instanceDataId, const VertData &data)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbos[instanceDataId]);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, data.vertices.size(), &data.vertices[0]);
+}
+
 void VertBuffer::deletePerInstanceData(GLuint instanceDataId)
 {
     bind();
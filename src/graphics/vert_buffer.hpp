@@ -24,6 +24,17 @@ class VertBuffer
     // try not to use this. It is more efficient to put more meshes (with the same VertAttributes) in 1 VertBuffer
     static void uploadSingleMesh(SharedMesh mesh);
 
+    /**
+     * queues mesh to be uploaded by uploadShared(), together with the other queued meshes that have the same VertAttributes.
+     *
+     * Meshes in the same VertBuffer can be drawn with one multi draw (see MultiDraw).
+     * The VertBuffer is deleted when all its meshes are destroyed, so a mesh that is replaced keeps its space until then.
+     **/
+    static void addShared(SharedMesh mesh);
+
+    // uploads the meshes queued by addShared(), one VertBuffer per distinct VertAttributes.
+    static void uploadShared();
+
     // adds mesh to Meshes that are going to be uploaded when upload() is called.
     VertBuffer* add(SharedMesh mesh);
 
@@ -36,8 +47,13 @@ class VertBuffer
 
     bool isUploaded() const;
 
+    // Changes every time meshes are uploaded or a VertBuffer loses a mesh, see PassCache
+    static unsigned int getUploadVersion() { return uploadVersion; }
+
     void bind();
 
+    GLuint getVaoId() const { return vaoId; }
+
     void onMeshDestroyed(); // Called by ~Mesh()
 
     /**
@@ -50,6 +66,11 @@ class VertBuffer
 
     void usePerInstanceData(GLuint instanceDataId, GLuint advanceRate=1);
 
+    /**
+     * Replaces the contents of uploaded instance data, data has to have the same attributes and size as the upload.
+     */
+    void updatePerInstanceData(GLuint instanceDataId, const VertData &data);
+
     void deletePerInstanceData(GLuint instanceDataId);
 
     ~VertBuffer();
@@ -80,5 +101,6 @@ class VertBuffer
 
     bool uploaded = false;
 
-    static GLuint currentlyBoundVao;
+    inline static unsigned int uploadVersion = 0;
+
 };
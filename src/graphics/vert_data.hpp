@@ -1,7 +1,12 @@
 #pragma once
 
+// Standard Headers
+#include <cstring>
+#include <string>
+
 // Local Headers
 #include "vert_attributes.hpp"
+#include "attribute_view.hpp"
 
 typedef unsigned char u_char;
 
@@ -16,7 +21,7 @@ class VertData
     std::vector<u_char> vertices;
 
     template <class type>
-    inline type get(int vertI, int attrOffset)
+    inline type get(int vertI, int attrOffset) const
     {
         type v;
         memcpy(
@@ -43,11 +48,46 @@ class VertData
         set(get<type>(vertI, attrOffset) + v, vertI, attrOffset);
     }
 
+    inline unsigned int nrOfVerts() const
+    {
+        return ((unsigned int) vertices.size()) / attributes.getVertSize();
+    }
+
+    /**
+     * Returns a typed view of the attribute at attrOffset for all vertices.
+     * The view is invalidated when vertices are added or removed.
+     */
+    template <class type>
+    inline AttributeView<type> view(int attrOffset)
+    {
+        return AttributeView<type>(vertices.data() + attrOffset, attributes.getVertSize(), nrOfVerts());
+    }
+
+    template <class type>
+    inline AttributeView<const type> view(int attrOffset) const
+    {
+        return AttributeView<const type>(vertices.data() + attrOffset, attributes.getVertSize(), nrOfVerts());
+    }
+
+    template <class type>
+    inline AttributeView<type> view(const VertAttr &attr)
+    {
+        return view<type>(attributes.getOffset(attr));
+    }
+
+    // Same as view(), but with the vertex size known at compile time.
+    template <class type, unsigned int VERT_SIZE>
+    inline AttributeView<type, VERT_SIZE> fixedView(int attrOffset)
+    {
+        if (attributes.getVertSize() != VERT_SIZE) throw "fixedView() does not match the vertex size of " + std::to_string(attributes.getVertSize());
+        return AttributeView<type, VERT_SIZE>(vertices.data() + attrOffset, VERT_SIZE, nrOfVerts());
+    }
+
     template <class vecType>
     void normalizeVecAttribute(int attrOffset)
     {
-        for (unsigned int vertI = 0; vertI < ((unsigned int) vertices.size()) / attributes.getVertSize(); vertI++)
-            set(normalize(get<vecType>(vertI, attrOffset)), vertI, attrOffset);
+        for (vecType &v : view<vecType>(attrOffset))
+            v = normalize(v);
     }
 
     void removeVertices(int count);
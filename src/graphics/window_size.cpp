@@ -38,6 +38,13 @@ void setInputWindow(GLFWwindow* window)
     glfwGetFramebufferSize(window, &nextWidthPixels, &nextHeightPixels);
 }
 
+void setSize(int widthPixels, int heightPixels)
+{
+    nextWidth = nextWidthPixels = widthPixels;
+    nextHeight = nextHeightPixels = heightPixels;
+    should_resize = true;
+}
+
 void resize()
 {
     WindowSize::width = nextWidth;
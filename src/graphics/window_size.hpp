@@ -12,5 +12,8 @@ namespace WindowSize
     extern bool should_resize;
 
     void setInputWindow(GLFWwindow* window);
+
+    // For rendering without a window, applied by the next resize()
+    void setSize(int widthPixels, int heightPixels);
     void resize();
 }
@@ -0,0 +1,362 @@
+#include "headless.hpp"
+
+// System Headers
+#include <glad/glad.h>
+#ifdef PLANETS_HEADLESS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+// Standard Headers
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+// Local Headers
+#include "scene.hpp"
+#include "graphics/gl_error.hpp"
+#include "graphics/gl_recorder.hpp"
+#include "graphics/profiler.hpp"
+#include "graphics/window_size.hpp"
+#include "graphics/input/key_input.hpp"
+#include "graphics/input/mouse_input.hpp"
+#include "utils/file/file.h"
+
+#include "graphics/imgui/imgui.h"
+#include "graphics/imgui/imgui_impl_opengl3.h"
+
+bool parseHeadlessOptions(int argc, char * argv[], HeadlessOptions &options)
+{
+    bool headless = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--headless") headless = true;
+        else if (arg == "--frames" && hasValue) options.frames = std::atoi(argv[++i]);
+        else if (arg == "--every" && hasValue) options.dumpInterval = std::atoi(argv[++i]);
+        else if (arg == "--out" && hasValue) options.outputDir = argv[++i];
+        else if (arg == "--seed" && hasValue) options.seed = std::atoi(argv[++i]);
+        else if (arg == "--record-gl") options.recordGL = true;
+        else if (arg == "--max-redundant" && hasValue) options.maxRedundant = std::atoi(argv[++i]);
+        else if (arg == "--size" && hasValue)
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2)
+                std::cerr << "Headless: --size has to look like 1280x720\n";
+        }
+    }
+    return headless;
+}
+
+namespace
+{
+
+#ifdef PLANETS_HEADLESS
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+struct EGLState
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLSurface surface = EGL_NO_SURFACE;
+    EGLContext context = EGL_NO_CONTEXT;
+};
+
+/**
+ * The default FrameBuffer is a pbuffer of the size of the frames, so the passes that draw to
+ * FrameBuffer 0 (the screen) work the same as with a window.
+ */
+bool createContext(int width, int height, EGLState &egl)
+{
+    // Needs no X server or GPU
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay) egl.display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (egl.display == EGL_NO_DISPLAY) egl.display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    if (egl.display == EGL_NO_DISPLAY || !eglInitialize(egl.display, NULL, NULL))
+    {
+        std::cerr << "Headless: no EGL display" << std::endl;
+        return false;
+    }
+
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint nrOfConfigs = 0;
+    if (!eglChooseConfig(egl.display, configAttributes, &config, 1, &nrOfConfigs) || nrOfConfigs == 0)
+    {
+        std::cerr << "Headless: no EGL config with pbuffers and OpenGL" << std::endl;
+        return false;
+    }
+
+    const EGLint surfaceAttributes[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+    egl.surface = eglCreatePbufferSurface(egl.display, config, surfaceAttributes);
+
+    eglBindAPI(EGL_OPENGL_API);
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    egl.context = eglCreateContext(egl.display, config, EGL_NO_CONTEXT, contextAttributes);
+
+    if (egl.surface == EGL_NO_SURFACE || egl.context == EGL_NO_CONTEXT || !eglMakeCurrent(egl.display, egl.surface, egl.surface, egl.context))
+    {
+        std::cerr << "Headless: failed to create an OpenGL 3.3 core context (EGL error " << eglGetError() << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void destroyContext(EGLState &egl)
+{
+    if (egl.display == EGL_NO_DISPLAY) return;
+
+    eglMakeCurrent(egl.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (egl.context != EGL_NO_CONTEXT) eglDestroyContext(egl.display, egl.context);
+    if (egl.surface != EGL_NO_SURFACE) eglDestroySurface(egl.display, egl.surface);
+    eglTerminate(egl.display);
+}
+
+#endif
+
+/**
+ * Binary PPM of the default FrameBuffer, top row first.
+ */
+void writeFrame(const std::string &path, int width, int height)
+{
+    std::vector<unsigned char> pixels(width * height * 3);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, &pixels[0]);
+
+    std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    std::vector<unsigned char> image(header.begin(), header.end());
+    image.reserve(header.size() + pixels.size());
+
+    // OpenGL starts at the bottom row
+    for (int y = height - 1; y >= 0; y--)
+        image.insert(image.end(), pixels.begin() + y * width * 3, pixels.begin() + (y + 1) * width * 3);
+
+    File::writeBinary(path.c_str(), image);
+}
+
+/**
+ * Orbits the first planet once every 60 seconds, a bit above its equator.
+ */
+CameraState orbit(double time)
+{
+    Planet * planet = Globals::scene->getUniverse().getPlanets().front();
+    float angle = time * 2 * mu::PI / 60.;
+    float distance = planet->config.radius * 2.5;
+
+    glm::vec3 center = planet->get_position();
+    glm::vec3 position = center + distance * glm::vec3(std::sin(angle), .3, std::cos(angle));
+
+    CameraState state;
+    state.position = position;
+    state.direction = glm::normalize(center - position);
+    state.right = glm::normalize(glm::cross(state.direction, mu::Y));
+    state.up = glm::cross(state.right, state.direction);
+    return state;
+}
+
+/**
+ * One line per GL call of the last recorded frame, the redundant ones are marked.
+ */
+void writeCallLog(const std::string &path)
+{
+    std::ofstream log(path);
+    for (const GLRecorder::Call &call : GLRecorder::getLastFrameCalls())
+        log << GLRecorder::functionName(call.function) << (call.redundant ? "  redundant\n" : "\n");
+}
+
+/**
+ * The functions with the most redundant calls per frame.
+ */
+void printRedundant(const std::vector<unsigned long long> &totals, unsigned int frames)
+{
+    std::vector<unsigned int> functions(totals.size());
+    std::iota(functions.begin(), functions.end(), 0);
+    std::sort(functions.begin(), functions.end(), [&](unsigned int a, unsigned int b) { return totals[a] > totals[b]; });
+
+    for (unsigned int i = 0; i < 5 && i < functions.size() && totals[functions[i]]; i++)
+        std::cout << "  " << GLRecorder::functionName(functions[i]) << ": " << totals[functions[i]] / (double) frames << " redundant calls per frame\n";
+}
+
+} // namespace
+
+int runHeadless(const HeadlessOptions &options)
+{
+    #ifdef PLANETS_HEADLESS
+    EGLState egl;
+    #endif
+
+    if (options.recordGL)
+    {
+        GLRecorder::install();
+        std::cout << "Headless: recording the GL calls, nothing is rendered" << std::endl;
+    }
+    else
+    {
+        #ifdef PLANETS_HEADLESS
+        if (!createContext(options.width, options.height, egl))
+        {
+            destroyContext(egl);
+            return EXIT_FAILURE;
+        }
+
+        if (!gladLoadGLLoader((GLADloadproc) eglGetProcAddress)) {
+            std::cerr << "Failed to initialize OpenGL context" << std::endl;
+            destroyContext(egl);
+            return EXIT_FAILURE;
+        }
+        std::cout << "OpenGL " << glGetString(GL_VERSION) << " (" << glGetString(GL_RENDERER) << ")" << std::endl;
+        #else
+        std::cerr << "Headless: this build has no offscreen context, configure it with -DPLANETS_HEADLESS=ON or use --record-gl" << std::endl;
+        return EXIT_FAILURE;
+        #endif
+    }
+
+    // The debug windows of the scene still need a frame to draw into, it is never rendered
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(options.width, options.height);
+    ImGui_ImplOpenGL3_Init("#version 330 core");
+
+    if (options.seed)
+    {
+        std::srand(options.seed);
+        PlanetGenerator::seed = options.seed;
+    }
+
+    WindowSize::setSize(options.width, options.height);
+
+    Globals::scene = new Scene();
+    Globals::scene->init();
+    Globals::scene->cameraPath = orbit;
+
+    WindowSize::resize();
+    Globals::scene->resize();
+    check_gl_error();
+
+    // A fixed time step, so every run renders the same frames
+    const float dt = 1 / 60.f;
+
+    std::ofstream csv(options.outputDir + "/frames.csv");
+    if (options.recordGL) csv << "frame,cpu_ms,calls,draws,state_changes,redundant_state_changes,uniforms,redundant_uniforms,uploads\n";
+    else csv << "frame,cpu_ms,frame_ms\n";
+
+    double totalCpu = 0, totalFrame = 0;
+
+    unsigned int mostRedundant = 0;
+    std::vector<unsigned long long> redundantPerFunction(GLRecorder::nrOfFunctions());
+
+    for (unsigned int frame = 0; frame < options.frames; frame++)
+    {
+        ImGui_ImplOpenGL3_NewFrame();
+        io.DeltaTime = dt;
+        ImGui::NewFrame();
+
+        // Only the calls of the scene count, the list of calls is kept for the last frame
+        if (options.recordGL)
+        {
+            GLRecorder::setCapture(frame + 1 == options.frames);
+            GLRecorder::nextFrame();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        // The CPU side of the frame: simulation, culling and submitting the draws
+        Globals::scene->update(dt);
+        auto submitted = std::chrono::steady_clock::now();
+
+        // Until the frame is actually rendered
+        glFinish();
+        auto finished = std::chrono::steady_clock::now();
+        check_gl_error();
+
+        KeyInput::update();
+        MouseInput::update();
+        ImGui::EndFrame();
+
+        double cpuMs = std::chrono::duration<double, std::milli>(submitted - start).count();
+        double frameMs = std::chrono::duration<double, std::milli>(finished - start).count();
+        totalCpu += cpuMs;
+        totalFrame += frameMs;
+
+        if (options.recordGL)
+        {
+            GLRecorder::nextFrame();
+            const GLRecorder::Stats &stats = GLRecorder::getLastFrameStats();
+
+            csv << frame << "," << cpuMs << "," << stats.calls << "," << stats.draws << "," << stats.stateChanges << ","
+                << stats.redundantStateChanges << "," << stats.uniforms << "," << stats.redundantUniforms << "," << stats.uploads << "\n";
+
+            mostRedundant = std::max(mostRedundant, stats.redundantStateChanges + stats.redundantUniforms);
+            for (unsigned int function = 0; function < redundantPerFunction.size(); function++)
+                redundantPerFunction[function] += stats.redundantPerFunction[function];
+            continue;
+        }
+
+        csv << frame << "," << cpuMs << "," << frameMs << "\n";
+
+        if (options.dumpInterval && frame % options.dumpInterval == 0)
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "/frame_%05u.ppm", frame);
+            writeFrame(options.outputDir + name, options.width, options.height);
+        }
+    }
+
+    // Ends the last frame, the GPU times of the last FRAMES_IN_FLIGHT - 1 frames are not read
+    Profiler::nextFrame();
+    Profiler::exportCsv(options.outputDir + "/profile.csv");
+    Profiler::exportChromeTrace(options.outputDir + "/trace.json");
+
+    int exitCode = EXIT_SUCCESS;
+
+    if (options.frames && options.recordGL)
+    {
+        std::cout << "Headless: " << options.frames << " frames, " << totalCpu / options.frames << " ms CPU per frame" << std::endl;
+        printRedundant(redundantPerFunction, options.frames);
+        writeCallLog(options.outputDir + "/gl_calls.txt");
+
+        if (options.maxRedundant >= 0 && mostRedundant > (unsigned int) options.maxRedundant)
+        {
+            std::cerr << "Headless: a frame has " << mostRedundant << " redundant state changes and uniform uploads, "
+                      << options.maxRedundant << " are allowed" << std::endl;
+            exitCode = EXIT_FAILURE;
+        }
+    }
+    else if (options.frames)
+        std::cout << "Headless: " << options.frames << " frames, " << totalCpu / options.frames << " ms CPU and "
+                  << totalFrame / options.frames << " ms total per frame" << std::endl;
+
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui::DestroyContext();
+
+    if (options.recordGL) GLRecorder::uninstall();
+    #ifdef PLANETS_HEADLESS
+    else destroyContext(egl);
+    #endif
+
+    return exitCode;
+}
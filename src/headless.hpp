@@ -0,0 +1,46 @@
+#pragma once
+
+// Standard Headers
+#include <string>
+
+/**
+ * Rendering without a window, for benchmarks and visual regression tests on machines without a GPU.
+ *
+ * An offscreen OpenGL 3.3 context is created with EGL (on Mesa the surfaceless platform works with llvmpipe),
+ * the camera orbits the first planet at a fixed time step and every n-th frame is written to disk as a PPM image,
+ * together with the CPU time of every frame in frames.csv. The Profiler samples of the last frames are written
+ * to profile.csv and trace.json (for chrome://tracing).
+ *
+ * With --record-gl no context is created at all: GLRecorder replaces the driver and every frame reports its GL calls,
+ * draws, state changes and uniform uploads (and the redundant ones) in frames.csv instead of writing images.
+ * This works in every build, the EGL context is only available when built with -DPLANETS_HEADLESS=ON.
+ */
+struct HeadlessOptions
+{
+    int width = 1280, height = 720;
+    unsigned int frames = 300;
+
+    // Every n-th frame is written, 0 writes none
+    unsigned int dumpInterval = 1;
+    std::string outputDir = ".";
+
+    // Seed of the planet generator and of std::rand, 0 for a different universe every run
+    int seed = 1;
+
+    // Record the GL calls instead of rendering, see GLRecorder
+    bool recordGL = false;
+
+    // Fails the run when a frame has more redundant state changes and uniform uploads, -1 for no limit
+    int maxRedundant = -1;
+};
+
+/**
+ * Returns false when --headless is not one of the arguments.
+ * Understands --frames N, --size WxH, --out DIR, --every N, --seed N, --record-gl and --max-redundant N.
+ */
+bool parseHeadlessOptions(int argc, char * argv[], HeadlessOptions &options);
+
+/**
+ * Returns the exit code of the program.
+ */
+int runHeadless(const HeadlessOptions &options);
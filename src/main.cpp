@@ -13,7 +13,9 @@
 
 // Local Headers
 #include "scene.hpp"
+#include "headless.hpp"
 #include "graphics/gl_error.hpp"
+#include "graphics/profiler.hpp"
 #include "graphics/window_size.hpp"
 #include "graphics/input/key_input.hpp"
 #include "graphics/input/mouse_input.hpp"
@@ -53,6 +55,14 @@ static void ShowOverlap(const char * text)
     if (ImGui::Begin("Info", NULL, (corner != -1 ? ImGuiWindowFlags_NoMove : 0) | ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav))
     {
         ImGui::TextUnformatted(text);
+
+        const Profiler::Frame * frame = Profiler::lastCompleteFrame();
+        if (frame)
+        {
+            double gpu = 0;
+            for (const Profiler::GpuSample &sample : frame->gpu) gpu += sample.duration;
+            ImGui::Text("Frame: %.2f ms, GPU: %.2f ms (F4 for details)", frame->duration, gpu);
+        }
         ImGui::Separator();
         if (ImGui::IsMousePosValid())
             ImGui::Text("Mouse Position: (%.1f,%.1f)", io.MousePos.x, io.MousePos.y);
@@ -74,6 +84,9 @@ static void ShowOverlap(const char * text)
 
 int main(int argc, char * argv[]) {
 
+    HeadlessOptions headless;
+    if (parseHeadlessOptions(argc, argv, headless)) return runHeadless(headless);
+
     // Load GLFW and Create a Window
     GLFWwindow * mWindow;
     glfwSetErrorCallback(&error_callback);
@@ -2,10 +2,10 @@
 
 // Standard Headers
 #include <limits>
-#include <glm/gtx/intersect.hpp>
 
 // Local Headers
 #include "graphics/window_size.hpp"
+#include "graphics/profiler.hpp"
 #include "graphics/input/key_input.hpp"
 #include "graphics/input/mouse_input.hpp"
 
@@ -17,11 +17,7 @@
 #include "graphics/renderers/sun_renderer.hpp"
 
 Scene::Scene():
-    camera(1, 1, 55), universe(), flyingCamera(&camera), planetCamera(&camera),
-    reflectionBuffer(512, 512) {
-
-    reflectionBuffer.addColorTexture(GL_RGB, GL_LINEAR, GL_LINEAR);
-    reflectionBuffer.addDepthBuffer();
+    camera(1, 1, 55), universe(), flyingCamera(&camera), planetCamera(&camera) {
 
     selected = universe.getPlanets()[0];
     camera.lookAt(glm::vec3(0.f));
@@ -50,16 +46,27 @@ void Scene::init() {
     renderers.push_back(new TerrainRenderer());
     renderers.push_back(new WaterRenderer());
     renderers.push_back(new SpaceRenderer());
-    renderers.push_back(new AtmosphereRenderer());
     renderers.push_back(new CloudRenderer());
     renderers.push_back(new PathRenderer());
 
+    // The queue draws the passes in this order
+    for (unsigned int i = 0; i < renderers.size(); i++)
+        renderers[i]->pass = i;
+
     underwater_renderer = new UnderwaterRenderer();
     shadow_renderer = new ShadowRenderer();
+    atmosphere_renderer = new AtmosphereRenderer();
     post_processing = new PostProcessing();
+
+    // One write per frame, and one per view: the shadow cascades and the main camera
+    frameUniforms = new UniformBuffer(UniformBlock::PER_FRAME, sizeof(PerFrameUniforms), 1);
+    viewUniforms = new UniformBuffer(UniformBlock::PER_VIEW, sizeof(PerViewUniforms), ShadowRenderer::NR_OF_CASCADES + 1);
 }
 
 void Scene::update(float dt) {
+    // A frame is everything between two updates, including ImGui and swapping the buffers
+    Profiler::nextFrame();
+
     draw(dt);
 
     if (MouseInput::justPressed(GLFW_MOUSE_BUTTON_LEFT)) {
@@ -72,13 +79,12 @@ void Scene::update(float dt) {
         Planet * nearest = nullptr;
         
         for (Planet * planet : universe.getPlanets()) {
-            float dist;
-            if (glm::intersectRaySphere(camera.getPosition(), rayDir, planet->get_position(), planet->config.radius * planet->config.radius, dist)) {
-                if (dist < nearestDist) {
-                    nearestDist = dist;
-                    nearest = planet;
-                }
-            } 
+            TerrainHit hit;
+            // Only hits closer than the nearest planet so far count.
+            if (planet->raycastTerrain(camera.getPosition(), rayDir, hit, nearestDist)) {
+                nearestDist = hit.distance;
+                nearest = planet;
+            }
         }
 
         if (nearest != nullptr) {
@@ -92,8 +98,21 @@ void Scene::update(float dt) {
 }
 
 void Scene::draw(float dt) {
+    Profiler::CpuScope profile("Scene::draw");
     check_gl_error();
 
+    // ImGui and resource loading change GL state without GLState
+    GLState::nextFrame();
+    GLState::invalidate();
+    renderTargets.nextFrame();
+
+    if (KeyInput::justPressed(GLFW_KEY_F3)) stateDebugMode = !stateDebugMode;
+    if (stateDebugMode) GLState::ShowDebugWindow(&stateDebugMode);
+
+    if (KeyInput::justPressed(GLFW_KEY_F4)) profilerMode = !profilerMode;
+    if (profilerMode) Profiler::ShowWindow(&profilerMode);
+
+    GLState::setDepthMask(true); // glClear respects the depth mask
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     check_gl_error();
 
@@ -101,35 +120,112 @@ void Scene::draw(float dt) {
 
     glm::vec3 sunPosition = universe.getSuns().front()->get_position();
     camera.sunDir = glm::normalize(sunPosition - camera.getPosition()); // universe.calculateSunDirection(planetCamera.lat, planetCamera.lon, planetCamera.actualZoom);
-   
-    glEnable(GL_BLEND);
-
-    shadow_renderer->render(dt);
 
-    // Render shadows
-    underwater_renderer->render(dt);
+    // Every pass below draws from this snapshot
+    renderView.build(universe);
+   
+    frameUniforms->nextFrame();
+    viewUniforms->nextFrame();
+    boundView = NULL;
+
+    PerFrameUniforms perFrame;
+    perFrame.sunDir = camera.sunDir;
+    perFrame.time = universe.getTime();
+    perFrame.scrSize = glm::vec2(WindowSize::widthPixels, WindowSize::heightPixels);
+    frameUniforms->write(perFrame);
+
+    buildFrameGraph(dt);
+    frameGraph.execute(renderTargets);
     check_gl_error();
+}
 
-    sceneBuffer->bind();
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    check_gl_error();
+void Scene::buildFrameGraph(float dt) {
+    frameGraph.reset();
+
+    typedef FrameGraph::PassBuilder Builder;
+
+    FrameGraph::Resource shadowMap = frameGraph.importTextureArray("shadow_map", shadow_renderer->sunDepthTexture);
+    FrameGraph::Resource underwater = frameGraph.importTarget("underwater", underwater_renderer->underwaterBuffer);
+    FrameGraph::Resource scene = frameGraph.createTarget("scene", {(GLuint) WindowSize::widthPixels, (GLuint) WindowSize::heightPixels, GL_RGB, true});
+    FrameGraph::Resource screen = frameGraph.importTarget("screen", NULL);
+    frameGraph.markOutput(screen);
+
+    // Binds the views of the shadow cascades
+    frameGraph.addPass("shadows", [&](Builder & pass) {
+        pass.write(shadowMap);
+    }, [this, dt]() {
+        shadow_renderer->render(dt);
+    });
+
+    frameGraph.addPass("underwater", [&](Builder & pass) {
+        pass.write(underwater);
+    }, [this, dt]() {
+        useCameraView();
+        underwater_renderer->render(dt);
+    });
+
+    // Terrain and water sample the shadow map and the underwater target
+    frameGraph.addPass("scene", [&](Builder & pass) {
+        pass.read(shadowMap);
+        pass.read(underwater);
+        pass.write(scene);
+    }, [this, dt]() {
+        useCameraView();
+
+        FrameBuffer * sceneBuffer = frameGraph.getTarget("scene");
+        sceneBuffer->bind();
+        GLState::setDepthMask(true);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        check_gl_error();
 
-    for (Renderer * renderer : renderers)
-    {
-        renderer->render(dt);
+        // The renderers only submit their draws, they are sorted and drawn by flush()
+        for (Renderer * renderer : renderers)
+        {
+            renderer->render(dt);
+            check_gl_error();
+        }
+        {
+            Profiler::CpuScope profile("RenderQueue::flush");
+            renderQueue.flush();
+        }
         check_gl_error();
-    }
-    
-    check_gl_error();
 
-    sceneBuffer->unbind();
-    // check_gl_error();
+        sceneBuffer->unbind();
+    });
+
+    // Reads the depth of the scene, so it is drawn after the opaque passes
+    frameGraph.addPass("atmosphere", [&](Builder & pass) {
+        pass.read(scene);
+        pass.write(scene);
+    }, [this, dt]() {
+        atmosphere_renderer->render(dt);
+    });
+
+    frameGraph.addPass("post_processing", [&](Builder & pass) {
+        pass.read(scene);
+        pass.write(screen);
+    }, [this, dt]() {
+        post_processing->render(dt);
+    });
+
+    frameGraph.compile();
+}
 
-    glEnable(GL_BLEND);
+void Scene::useCameraView() {
+    if (boundView != &camera) bindView(camera);
+}
 
-    // Post Processing
-    post_processing->render(dt);
-    check_gl_error();
+void Scene::bindView(const Camera & viewCamera) {
+    PerViewUniforms perView;
+    perView.viewProjection = viewCamera.combined;
+    perView.view = viewCamera.view;
+    perView.projection = viewCamera.projection;
+    for (unsigned int i = 0; i < ShadowRenderer::NR_OF_CASCADES; i++)
+        perView.shadowMatrices[i] = shadow_renderer->getShadowMatrix(i);
+    perView.cascadeSplits = shadow_renderer->getCascadeSplits();
+    perView.camPos = viewCamera.getPosition();
+    viewUniforms->write(perView);
+    boundView = &viewCamera;
 }
 
 void Scene::updateCamera(float dt) {
@@ -144,7 +240,10 @@ void Scene::updateCamera(float dt) {
         MouseInput::setLockedMode(!camPlanetMode);
     }
 
-    if (camPlanetMode) {
+    if (cameraPath) {
+        camera.moveTo(cameraPath(universe.getTime()), false);
+    }
+    else if (camPlanetMode) {
         // Check if I should animate to the new planet
         if (planetCamera.planet != selected) {
             // camera.lookAt(selected->get_position());
@@ -186,8 +285,5 @@ void Scene::resize()
     camera.viewportWidth = WindowSize::widthPixels;
     camera.viewportHeight = WindowSize::heightPixels;
 
-    if (sceneBuffer) delete sceneBuffer;
-    sceneBuffer = new FrameBuffer(WindowSize::widthPixels, WindowSize::heightPixels, 0);
-    sceneBuffer->addColorTexture(GL_RGB, GL_LINEAR, GL_LINEAR);
-    sceneBuffer->addDepthTexture(GL_LINEAR, GL_LINEAR);
+    // The scene buffer of the new size is taken from the RenderTargetPool by the next draw()
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+// Standard Headers
+#include <functional>
+
 // Local Heads
 #include "graphics/camera.hpp"
 #include "graphics/controls/flying_camera.hpp"
@@ -8,9 +11,15 @@
 #include "graphics/input/key_input.hpp"
 #include "graphics/renderable.hpp"
 #include "graphics/frame_buffer.hpp"
+#include "graphics/render_target_pool.hpp"
+#include "graphics/frame_graph.hpp"
+#include "graphics/render_view.hpp"
+#include "graphics/render_queue.hpp"
+#include "graphics/uniform_buffer.hpp"
 #include "graphics/renderers/shadow_renderer.hpp"
 #include "graphics/renderers/space_renderer.hpp"
 #include "graphics/renderers/underwater_renderer.hpp"
+#include "graphics/renderers/atmosphere_renderer.hpp"
 #include "graphics/renderers/post_processing.hpp"
 #include "common/universe.hpp"
 
@@ -18,13 +27,24 @@ class Scene {
     private:
         Camera camera;
         Universe universe;
+        RenderView renderView;
 
         bool camPlanetMode = true;
         bool camDebugMode = true;
+        bool stateDebugMode = false;
+        bool profilerMode = false;
         void updateCamera(float dt);
 
         bool cursorToLonLat(const glm::vec3 & rayDir, vec2 &lonLat, float offset) const;
 
+        // Camera of the last bindView() this frame
+        const Camera * boundView = NULL;
+
+        void buildFrameGraph(float dt);
+
+        // Binds the view of the main camera, unless it is still bound
+        void useCameraView();
+
 
         std::vector<Renderable *> _objects;
     public:
@@ -34,20 +54,36 @@ class Scene {
         FlyingCamera flyingCamera;
         PlanetCamera planetCamera;
 
+        // When set the camera follows this path instead of the controls, it gets the universe time
+        std::function<CameraState(double time)> cameraPath;
+
         std::vector<Renderer *> renderers;
         
         ShadowRenderer * shadow_renderer;
+        AtmosphereRenderer * atmosphere_renderer;
         UnderwaterRenderer * underwater_renderer;
         PostProcessing * post_processing;
-        FrameBuffer reflectionBuffer, *sceneBuffer = NULL;
+        RenderTargetPool renderTargets;
+
+        // Rebuilt every frame by draw(), the passes find their inputs in it ("scene", "shadow_map", "underwater")
+        FrameGraph frameGraph;
+        UniformBuffer *frameUniforms = NULL, *viewUniforms = NULL;
+        RenderQueue renderQueue;
 
-        const Universe & getUniverse() { return universe; }
+        const Camera & getCamera() const { return camera; }
+        const Universe & getUniverse() const { return universe; }
+        const RenderView & getRenderView() const { return renderView; }
 
         void resize();
         void init();
         void draw(float dt);
         void update(float dt);
 
+        /**
+         * Writes the PerView block for the camera of a pass, shared by all shaders until the next call.
+         */
+        void bindView(const Camera & viewCamera);
+
         // void add_renderable(Renderable * renderable, Renderable * parent = nullptr);
         friend class Renderer;
 };
@@ -7,9 +7,11 @@
 // Local Headers
 #include "utils/math_utils.h"
 #include "utils/math/interpolation.h"
+#include "utils/parallel.h"
 #include "geometry/cubesphere.hpp"
 
 #include "graphics/tangent_calculator.hpp"
+#include "graphics/profiler.hpp"
 #include "graphics/imgui/imgui.h"
 
 
@@ -43,6 +45,8 @@ void PlanetGenerator::ShowDebugWindow(bool* p_open)
     ImGui::Text("MOUNTAINS");
     funcs::ConfigureNoiseLayer(1, MOUNTAINS);
 
+    ImGui::Checkbox("Normals from noise gradient", &NOISE_NORMALS);
+
     ImGui::End();
 }
 
@@ -93,96 +97,81 @@ float PlanetGenerator::simpleNoise(NoiseLayer config, const glm::vec3 & unitSphe
     return noiseValue * config.strength;
 }
 
-float PlanetGenerator::calculateGrass(const glm::vec3 & unitSphere, VertexCharacteristics v) {
-    if (v.height < GRASS_LEVEL || v.height > ROCK_LEVEL) return 0;
-
-    float frequency = 6;
-    float noise = 0.5 * (grassNoise.GetValue(unitSphere.x * frequency, unitSphere.y * frequency, unitSphere.z * frequency) + 1);
-
-    float steepness = v.maxNeighbor - v.minNeighbor;
-    float rockiness = clamp(steepness, 0.f, 1.f);
-
-    // int maxDist = 1 + (int)(30 * abs(noise));
-    // float dist = max(0.f, min(v.distToGrass, (float) maxDist + 3) - 3);
-    return clamp(noise * (1-rockiness), 0.f, 1.f);
-}
-
-float PlanetGenerator::calculateDeadGrass(const glm::vec3 & unitSphere, VertexCharacteristics v) {
-    if (v.height < GRASS_LEVEL || v.height > ROCK_LEVEL) return 0;
-    // float noiseX = x + DEAD_GRASS_NOISE_OFFSET, noiseY = y + DEAD_GRASS_NOISE_OFFSET;
-
-    float noise = deadGrassNoise.GetValue(unitSphere.x + DEAD_GRASS_NOISE_OFFSET, unitSphere.y + DEAD_GRASS_NOISE_OFFSET, unitSphere.z + DEAD_GRASS_NOISE_OFFSET);
-
-    return clamp((noise - .2) * 3., 0.0, 1.0);
-}
-
-float PlanetGenerator::calculateRock2(const glm::vec3 & unitSphere, VertexCharacteristics v) {
-    if (v.height < ROCK_LEVEL) return 0;
-
-//    float noise = planetNoise.GetValue(unitSphere.x, unitSphere.y, unitSphere.z);
-
-    return 1. - clamp<float>(v.maxNeighbor - v.height, 0., 1.);
-}
+void PlanetGenerator::calculateCharacteristics(Mesh * mesh, VertexCharacteristics &v)
+{
+    unsigned int yLevelOffset = mesh->attributes.getOffset({"Y_LEVEL", 1});
+    unsigned int nVertices = mesh->nrOfVertices;
 
-float PlanetGenerator::calculateRock(const glm::vec3 & unitSphere, VertexCharacteristics v) {
-    if (v.height < ROCK_LEVEL) return 0;
+    v.height.resize(nVertices);
+    v.minNeighbor.resize(nVertices);
+    v.maxNeighbor.resize(nVertices);
 
-    float steepness = v.maxNeighbor - v.minNeighbor;
+    auto yLevels = mesh->view<const float>(yLevelOffset);
+    std::copy(yLevels.begin(), yLevels.end(), v.height.begin());
 
-    float rockness = clamp<float>(steepness, 0., 1.) + (v.height > 3 ? 1 : 0);
-    // rockness *= 1. - v.distToRock / 3.;
-    return rockness;
+    // Gather the height range of the surrounding vertices, including the vertex itself.
+    const MeshTopology &topology = mesh->getTopology();
+    parallel::forEach(nVertices, [&](unsigned int i) {
+        float minHeight = v.height[i], maxHeight = v.height[i];
+        for (unsigned int n = topology.neighborOffsets[i]; n < topology.neighborOffsets[i + 1]; n++)
+        {
+            minHeight = std::min(minHeight, v.height[topology.vertexNeighbors[n]]);
+            maxHeight = std::max(maxHeight, v.height[topology.vertexNeighbors[n]]);
+        }
+        v.minNeighbor[i] = minHeight;
+        v.maxNeighbor[i] = maxHeight;
+    });
 }
 
-
 void PlanetGenerator::addTextureMaps(Mesh * mesh) {
     VertAttributes &attrs = mesh->attributes;
     unsigned int posOffset = attrs.getOffset(VertAttributes::POSITION); 
     unsigned int texOffset = attrs.getOffset({"TEX_BLEND", 4});
-    unsigned int yLevelOffset = attrs.getOffset({"Y_LEVEL", 1});
-
-    std::vector<VertexCharacteristics> characteristics(mesh->nrOfVertices, {99999, -99999, 99999, 0, 0});
-
-    // Calculate attributes with on neighbors 
-    for (unsigned int i = 0; i < mesh->nrOfIndices; i += 3)
-    {
-        int vertI0 = mesh->indices[i], vertI1 = mesh->indices[i + 1], vertI2 = mesh->indices[i + 2];
+    unsigned int nVertices = mesh->nrOfVertices;
 
-        auto y0 = mesh->get<float>(vertI0, yLevelOffset),
-            y1 = mesh->get<float>(vertI1, yLevelOffset),
-            y2 = mesh->get<float>(vertI2, yLevelOffset);
+    VertexCharacteristics v;
+    calculateCharacteristics(mesh, v);
 
-        characteristics[vertI0].height = y0;
-        characteristics[vertI1].height = y1;
-        characteristics[vertI2].height = y2;
+    auto positions = mesh->view<const glm::vec3>(posOffset);
+    auto textureMaps = mesh->view<glm::vec4>(texOffset);
 
-        // Rock isl->distToHeight(x, y, 1.5, 999, 3)
+    // Noise is the expensive part, so only evaluate it once per vertex, and only where grass can grow.
+    std::vector<float> grass(nVertices, 0.f), deadGrass(nVertices, 0.f);
+    for (unsigned int i = 0; i < nVertices; i++)
+    {
+        if (v.height[i] < GRASS_LEVEL || v.height[i] > ROCK_LEVEL) continue;
 
-        float minHeight = min(y0, min(y1, y2));
-        characteristics[vertI0].minNeighbor = min(characteristics[vertI0].minNeighbor, minHeight);
-        characteristics[vertI1].minNeighbor = min(characteristics[vertI1].minNeighbor, minHeight);
-        characteristics[vertI1].minNeighbor = min(characteristics[vertI1].minNeighbor, minHeight);
+        const glm::vec3 &pos = positions[i];
 
-        float maxHeight = max(y0, max(y1, y2));
-        characteristics[vertI0].maxNeighbor = max(characteristics[vertI0].maxNeighbor, maxHeight);
-        characteristics[vertI1].maxNeighbor = max(characteristics[vertI1].maxNeighbor, maxHeight);
-        characteristics[vertI1].maxNeighbor = max(characteristics[vertI1].maxNeighbor, maxHeight);
+        float frequency = 6;
+        grass[i] = 0.5 * (grassNoise.GetValue(pos.x * frequency, pos.y * frequency, pos.z * frequency) + 1);
+        deadGrass[i] = deadGrassNoise.GetValue(pos.x + DEAD_GRASS_NOISE_OFFSET, pos.y + DEAD_GRASS_NOISE_OFFSET, pos.z + DEAD_GRASS_NOISE_OFFSET);
     }
 
-    for (unsigned int i = 0; i < mesh->nrOfIndices; i ++) {
-        int vertI = mesh->indices[i];
+    // Blend weights. Branch free on plain arrays, so the compiler can vectorize it.
+    std::vector<float> grassWeight(nVertices), deadGrassWeight(nVertices), rockWeight(nVertices), rock2Weight(nVertices);
+    const float *height = v.height.data(), *minNeighbor = v.minNeighbor.data(), *maxNeighbor = v.maxNeighbor.data();
 
-        auto pos = mesh->get<glm::vec3>(vertI, posOffset);
+    for (unsigned int i = 0; i < nVertices; i++)
+    {
+        float land = (height[i] >= GRASS_LEVEL && height[i] <= ROCK_LEVEL) ? 1.f : 0.f;
+        float rock = height[i] >= ROCK_LEVEL ? 1.f : 0.f;
 
-        VertexCharacteristics v = characteristics[vertI];
+        float steepness = std::min(std::max(maxNeighbor[i] - minNeighbor[i], 0.f), 1.f);
 
-        glm::vec4 textureMap(0.f, 0.f, 0, 0);
-        textureMap[GRASS_TEX] = calculateGrass(pos, v);
-        textureMap[DEAD_GRASS_TEX] = calculateDeadGrass(pos, v);
-        textureMap[ROCK_TEX] = calculateRock(pos, v);
-        textureMap[ROCK2_TEX] = calculateRock2(pos, v);
-        
-        mesh->add<glm::vec4>(textureMap, vertI, texOffset);
+        grassWeight[i] = land * std::min(std::max(grass[i] * (1.f - steepness), 0.f), 1.f);
+        deadGrassWeight[i] = land * std::min(std::max((deadGrass[i] - .2f) * 3.f, 0.f), 1.f);
+        rockWeight[i] = rock * (steepness + (height[i] > 3 ? 1.f : 0.f));
+        rock2Weight[i] = rock * (1.f - std::min(std::max(maxNeighbor[i] - height[i], 0.f), 1.f));
+    }
+
+    for (unsigned int i = 0; i < nVertices; i++)
+    {
+        glm::vec4 &textureMap = textureMaps[i];
+        textureMap[GRASS_TEX] = grassWeight[i];
+        textureMap[DEAD_GRASS_TEX] = deadGrassWeight[i];
+        textureMap[ROCK_TEX] = rockWeight[i];
+        textureMap[ROCK2_TEX] = rock2Weight[i];
     }
 }
 
@@ -192,9 +181,41 @@ float PlanetGenerator::calculateElevation(const glm::vec3 & unitSphere) {
     return continent + ridgedNoise(MOUNTAINS, unitSphere, 0.78) * continent;
 }
 
+glm::vec3 PlanetGenerator::calculateNormal(const glm::vec3 & unitSphere, float radius) {
+    // The terrain is a radial height field: r(u) = radius + elevation(u).
+    // Its normal is u - grad(elevation) / r, with the gradient taken along the unit sphere.
+    const float EPSILON = 1e-3f;
+
+    glm::vec3 t1 = glm::normalize(glm::cross(unitSphere, std::abs(unitSphere.y) < .99f ? mu::Y : mu::X));
+    glm::vec3 t2 = glm::cross(unitSphere, t1);
+
+    float d1 = calculateElevation(glm::normalize(unitSphere + EPSILON * t1)) - calculateElevation(glm::normalize(unitSphere - EPSILON * t1));
+    float d2 = calculateElevation(glm::normalize(unitSphere + EPSILON * t2)) - calculateElevation(glm::normalize(unitSphere - EPSILON * t2));
+
+    glm::vec3 gradient = (d1 * t1 + d2 * t2) / (2.f * EPSILON);
+    return glm::normalize(unitSphere - gradient / radius);
+}
+
+void PlanetGenerator::addNoiseNormals(Mesh * mesh) {
+    unsigned int posOffset = mesh->attributes.getOffset(VertAttributes::POSITION);
+    unsigned int norOffset = mesh->attributes.getOffset(VertAttributes::NORMAL);
+
+    auto positions = mesh->view<const glm::vec3>(posOffset);
+    auto normals = mesh->view<glm::vec3>(norOffset);
+
+    // Every vertex is independent, no topology needed.
+    parallel::forEach(mesh->nrOfVertices, [&](unsigned int i) {
+        normals[i] = calculateNormal(glm::normalize(positions[i]), glm::length(positions[i]));
+    }, 256);
+}
+
+int PlanetGenerator::seed = 0;
+
 void PlanetGenerator::generate(Planet *plt)
 {
-    planetNoise.SetSeed(time(0));
+    Profiler::CpuScope profile("PlanetGenerator::generate");
+
+    planetNoise.SetSeed(seed ? seed : time(0));
 
     VertAttributes terrainAttrs;
     unsigned int posOffset = terrainAttrs.add(VertAttributes::POSITION);
@@ -211,9 +232,6 @@ void PlanetGenerator::generate(Planet *plt)
         .add_(VertAttributes::TANGENT);
 
 
-    VertAttributes atmosphereAttrs;
-    atmosphereAttrs.add_(VertAttributes::POSITION).add_(VertAttributes::NORMAL);
-
     PlanetConfig config = plt->config;
 
     // Make a unit sphere
@@ -227,14 +245,16 @@ void PlanetGenerator::generate(Planet *plt)
     Sphere water(config.radius);
     plt->waterMesh = water.generate(plt->config.name + "_water", 100, 70, waterAttrs); //sphere.gstd::make_shared<Mesh>(plt->config.name + "_water", nVertices, nIndices, attrs);
 
-    Sphere atmosphere(config.radius + 50);
-    plt->atmosphereMesh = atmosphere.generate(plt->config.name + "_atmosphere", 50, 130, atmosphereAttrs);
+    plt->atmosphere = AtmosphereLUT::get(config.radius, config.atmosphere);
 
     const float * vertices = cubesphere.getVertices();
 //    const float * normals = cubesphere.getNormals();
     const float * texCords = cubesphere.getTexCoords();
 
-    std::vector<vec4> textureMap(nVertices, vec4());
+    auto positions = plt->terrainMesh->view<glm::vec3>(posOffset);
+    auto texCoords = plt->terrainMesh->view<glm::vec2>(uvOffset);
+    auto textureMaps = plt->terrainMesh->view<glm::vec4>(texOffset);
+    auto yLevels = plt->terrainMesh->view<float>(yLevelOffset);
 
     for (unsigned int i = 0; i < nVertices; i++) {
         // plt->waterMesh->set(glm::vec3(vertices[3 * i], vertices[3 * i + 1], vertices[3 * i + 2]), i, posOffset);
@@ -247,26 +267,33 @@ void PlanetGenerator::generate(Planet *plt)
         // Creating noise!
         float terrainHeight = calculateElevation(pos);
 
-        plt->terrainMesh->set(terrainHeight, i, yLevelOffset);
+        yLevels[i] = terrainHeight;
 
         std::cout << "Height for pos: " << glm::to_string(pos) << " " << terrainHeight  + config.radius << std::endl;
-        plt->terrainMesh->set<glm::vec3>(pos + ((terrainHeight + config.radius) * normal), i, posOffset);
+        positions[i] = pos + ((terrainHeight + config.radius) * normal);
 
         // Recalculate textures and normals
         // plt->terrainMesh->set(glm::vec3(normals[3 * i], normals[3 * i + 1], normals[3 * i + 2]), i, norOffset);
-        plt->terrainMesh->set(glm::vec2(texCords[2 * i], texCords[2 * i + 1]), i, uvOffset);
-        plt->terrainMesh->set(glm::vec4(0, 0, 0, 0), i, texOffset);
+        texCoords[i] = glm::vec2(texCords[2 * i], texCords[2 * i + 1]);
+        textureMaps[i] = glm::vec4(0, 0, 0, 0);
     }
 
     const unsigned int * indices = cubesphere.getIndices();
     for (unsigned int i = 0; i < nIndices; i++) {
         plt->terrainMesh->indices[i] = indices[i];
     }
+    plt->terrainMesh->invalidateTopology();
 
     TangentCalculator::addTangentsToMesh(plt->terrainMesh);
-    plt->terrainMesh->computeSmoothingNormals();
+    if (NOISE_NORMALS)
+        addNoiseNormals(plt->terrainMesh.get());
+    else
+        plt->terrainMesh->computeSmoothingNormals();
 
     addTextureMaps(plt->terrainMesh.get());
 
+    plt->heightMap = std::make_shared<TerrainHeightMap>(*plt->terrainMesh, config.subdivision);
+    plt->climate = std::make_shared<Climate>(*plt, config.climateCells);
+
     plt->upload();
 }
@@ -5,12 +5,13 @@
 // #include <FastNoiseSIMD/FastNoiseSIMD.h>
 #include "utils/math/FastNoise.h"
 
+/**
+ * Per vertex inputs of the texture blending, stored as structure of arrays.
+ */
 struct VertexCharacteristics {
-    float height;
-    float minNeighbor;
-    float maxNeighbor;
-    float distToGrass;
-    float distToRock;
+    std::vector<float> height;
+    std::vector<float> minNeighbor;
+    std::vector<float> maxNeighbor;
     // float nearestRock;
     // float nearestSea;
 };
@@ -31,6 +32,9 @@ namespace {
 
     static float DEAD_GRASS_NOISE_OFFSET = 500;
 
+    // Take the normals from the gradient of the elevation noise instead of averaging face normals
+    static bool NOISE_NORMALS = false;
+
     static NoiseLayer CONTINENTS = {
     4, 3.08f, 1.07, 1.5, 1.1, -1.2
     };
@@ -49,17 +53,20 @@ private:
     float ridgedNoise(NoiseLayer config, const glm::vec3 & unitSphere, float weightMultiplier);
     float simpleNoise(NoiseLayer config, const glm::vec3 & unitSphere);
     float calculateElevation(const glm::vec3 & unitSphere);
+    glm::vec3 calculateNormal(const glm::vec3 & unitSphere, float radius);
 
     float distToHeight(const glm::vec3 & unitSphere, float minHeight, float maxHeight, int maxDist) const;
 
-    float calculateGrass(const glm::vec3 & unitSphere, VertexCharacteristics v);
-    float calculateDeadGrass(const glm::vec3 & unitSphere, VertexCharacteristics v);
-    float calculateRock(const glm::vec3 & unitSphere, VertexCharacteristics v);
-    float calculateRock2(const glm::vec3 & unitSphere, VertexCharacteristics v);
+    void calculateCharacteristics(Mesh * mesh, VertexCharacteristics &v);
 
     void addTextureMaps(Mesh * mesh);
+    void addNoiseNormals(Mesh * mesh);
 public:
     PlanetGenerator();
+
+    // Seed of the terrain noise, 0 seeds it with the time. Set it for the same planets every run.
+    static int seed;
+
     void generate(Planet *plt);
     static void ShowDebugWindow(bool* p_open);
 };
@@ -0,0 +1,57 @@
+#pragma once
+
+// Standard Headers
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace parallel
+{
+
+/**
+ * Splits [0, count) into one chunk per hardware thread and calls fn(begin, end) for each chunk.
+ * Returns when all chunks are done. Small ranges are run on the calling thread.
+ *
+ * fn must only write to data owned by its own chunk.
+ */
+template <class Fn>
+void forChunks(unsigned int count, const Fn &fn, unsigned int minChunkSize = 2048)
+{
+    unsigned int nrOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    nrOfThreads = std::min(nrOfThreads, std::max(1u, count / minChunkSize));
+
+    if (nrOfThreads <= 1)
+    {
+        fn(0u, count);
+        return;
+    }
+
+    unsigned int chunkSize = (count + nrOfThreads - 1) / nrOfThreads;
+
+    std::vector<std::thread> threads;
+    threads.reserve(nrOfThreads - 1);
+
+    for (unsigned int t = 1; t < nrOfThreads; t++)
+    {
+        unsigned int begin = t * chunkSize, end = std::min(count, begin + chunkSize);
+        if (begin < end) threads.emplace_back([&fn, begin, end] { fn(begin, end); });
+    }
+
+    // The calling thread takes the first chunk
+    fn(0u, std::min(count, chunkSize));
+
+    for (std::thread &thread : threads) thread.join();
+}
+
+/**
+ * Calls fn(i) for every i in [0, count) on multiple threads.
+ */
+template <class Fn>
+void forEach(unsigned int count, const Fn &fn, unsigned int minChunkSize = 2048)
+{
+    forChunks(count, [&fn](unsigned int begin, unsigned int end) {
+        for (unsigned int i = begin; i < end; i++) fn(i);
+    }, minChunkSize);
+}
+
+} // namespace parallel
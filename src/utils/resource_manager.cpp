@@ -18,7 +18,7 @@
 #endif
 
 // std::map<string::string, SharedModel> ResourceManager::Models;
-std::map<std::string, Shader> ResourceManager::Shaders;
+std::map<std::string, SharedShader> ResourceManager::Shaders;
 std::map<std::string, SharedTexture> ResourceManager::Textures;
 std::map<std::string, SharedTexArray> ResourceManager::TextureArrays;
 std::map<std::string, SharedCubeMap> ResourceManager::CubeMaps;
@@ -38,10 +38,10 @@ static bool FileExists(const char * abs_filename) {
     return ret;
 }
 
-Shader ResourceManager::LoadShader(std::string vShaderFile, std::string fShaderFile, std::string name)
+SharedShader ResourceManager::LoadShader(std::string vShaderFile, std::string fShaderFile, std::string name)
 {
-    Shader shader;
-    shader.init_from_files(vShaderFile, fShaderFile);
+    SharedShader shader = std::make_shared<Shader>();
+    shader->init_from_files(vShaderFile, fShaderFile);
     Shaders[name] = shader;
 
     check_gl_error();
@@ -100,7 +100,7 @@ SharedTexArray  ResourceManager::GetTextureArray(std::string name) {
     return TextureArrays[name];
 }
 
-Shader ResourceManager::GetShader(std::string name)
+SharedShader ResourceManager::GetShader(std::string name)
 {
     return Shaders[name];
 }
@@ -136,7 +136,7 @@ void ResourceManager::Clear()
 {
     // (properly) delete all shaders	
     for (auto iter : Shaders)
-        glDeleteProgram(iter.second.program_id);
+        glDeleteProgram(iter.second->program_id);
     // (properly) delete all textures
     for (auto iter : Textures)
         glDeleteTextures(1, &iter.second->id);
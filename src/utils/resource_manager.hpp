@@ -17,7 +17,7 @@ class ResourceManager
 {
     public:
         // static std::map<std::string, SharedModel>   Models;
-        static std::map<std::string, Shader>              Shaders;
+        static std::map<std::string, SharedShader>        Shaders;
         static std::map<std::string, SharedTexture>       Textures;
         static std::map<std::string, SharedTexArray>      TextureArrays;
         static std::map<std::string, SharedCubeMap>       CubeMaps;
@@ -28,8 +28,8 @@ class ResourceManager
         // static SharedModel   GetModel(std::string name);
 
         // Loads (and generates) a shader program from file loading vertex, fragment (and geometry) shader's source code. If gShaderFile is not nullptr, it also loads a geometry shader
-        static Shader           LoadShader(std::string vShaderFile, std::string fShaderFile, std::string name);
-        static Shader           GetShader(std::string name);
+        static SharedShader     LoadShader(std::string vShaderFile, std::string fShaderFile, std::string name);
+        static SharedShader     GetShader(std::string name);
 
         static SharedTexture    PutTexture(SharedTexture texture, std::string name);
         static SharedTexture    LoadTexture(std::string file, std::string name);